@@ -0,0 +1,30 @@
+#include "graph.h"
+#include "thread_pool.h"
+#include "min_heap.h"
+#include "d_ary_heap.h"
+#include "pairing_heap.h"
+#include "radix_heap.h"
+
+std::vector<ShortestPathResult> Graph::BatchBFS(const std::vector<int>& sources, ThreadPool& pool) const {
+    std::vector<ShortestPathResult> results(sources.size(), ShortestPathResult(0, 0));
+    pool.Run(sources.size(), [&](int i) {
+        results[i] = this->BFS(sources[i]);
+    });
+    return results;
+}
+
+template <typename Heap>
+std::vector<ShortestPathResult> Graph::BatchDijkstra(const std::vector<int>& sources, ThreadPool& pool) const {
+    std::vector<ShortestPathResult> results(sources.size(), ShortestPathResult(0, 0));
+    pool.Run(sources.size(), [&](int i) {
+        results[i] = this->Dijkstra<Heap>(sources[i]);
+    });
+    return results;
+}
+
+// The heap implementations batches are built with
+template std::vector<ShortestPathResult> Graph::BatchDijkstra<MinHeap>(const std::vector<int>& sources, ThreadPool& pool) const;
+template std::vector<ShortestPathResult> Graph::BatchDijkstra<DaryHeap<4>>(const std::vector<int>& sources, ThreadPool& pool) const;
+template std::vector<ShortestPathResult> Graph::BatchDijkstra<DaryHeap<8>>(const std::vector<int>& sources, ThreadPool& pool) const;
+template std::vector<ShortestPathResult> Graph::BatchDijkstra<PairingHeap>(const std::vector<int>& sources, ThreadPool& pool) const;
+template std::vector<ShortestPathResult> Graph::BatchDijkstra<RadixHeap>(const std::vector<int>& sources, ThreadPool& pool) const;
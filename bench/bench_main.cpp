@@ -0,0 +1,298 @@
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "benchmark.h"
+#include "graph.h"
+#include "generator.h"
+#include "min_heap.h"
+#include "d_ary_heap.h"
+#include "pairing_heap.h"
+#include "radix_heap.h"
+#include "thread_pool.h"
+
+static const char* allSuites = "load,dfs,components,bfs,dijkstra,prim,mst,heap";
+
+typedef std::set<std::string> SuiteSet;
+
+// Splits a comma separated suite list, false if a name isn't one of allSuites
+static bool ParseSuites(std::string list, SuiteSet& suites) {
+    SuiteSet known;
+    std::string name;
+    std::istringstream all(allSuites);
+    while (getline(all, name, ','))
+        known.insert(name);
+
+    suites.clear();
+    std::istringstream ss(list);
+    while (getline(ss, name, ',')) {
+        if (!known.count(name)) {
+            std::cerr << "Unknown suite: " << name << std::endl;
+            return false;
+        }
+        suites.insert(name);
+    }
+    return true;
+}
+
+// Everything a suite needs to know about the run
+struct BenchContext {
+    BenchmarkOptions options;
+    BenchmarkReport report;
+    unsigned char graphOptions;
+    int threads;
+};
+
+// Vertices reached and the sum of their distances, to compare runs
+static long long Checksum(const ShortestPathResult& result) {
+    long long sum = 0;
+    for (int32_t d : result.distance) {
+        if (d != INT32_MAX)
+            sum += d + 1;
+    }
+    return sum;
+}
+
+template <typename Run>
+static void Bench(BenchContext& ctx, std::string suite, std::string name, std::string input, int threads, Run run) {
+    long long check = 0;
+    Timing t = Measure(ctx.options, [] {}, [&] { check = run(); });
+    ctx.report.Add(BenchmarkRow{ suite, name, input, threads, 1, t, check });
+}
+
+static void BenchLoad(BenchContext& ctx, std::string file) {
+    unsigned char opts = ctx.graphOptions & ~(FastLoad | ParallelLoad);
+    Bench(ctx, "load", "stream", file, 1, [&] {
+        Graph g(file, opts);
+        return 0LL;
+    });
+    Bench(ctx, "load", "mapped", file, 1, [&] {
+        Graph g(file, opts | FastLoad);
+        return 0LL;
+    });
+    Bench(ctx, "load", "parallel", file, ctx.threads, [&] {
+        Graph g(file, opts | ParallelLoad, ctx.threads);
+        return 0LL;
+    });
+}
+
+template <typename Heap>
+static void BenchDijkstra(BenchContext& ctx, const Graph& g, std::string name, std::string file) {
+    Bench(ctx, "dijkstra", name, file, 1, [&] { return Checksum(g.Dijkstra<Heap>(1)); });
+}
+
+template <typename Heap>
+static void BenchPrim(BenchContext& ctx, const Graph& g, std::string name, std::string file) {
+    Bench(ctx, "prim", name, file, 1, [&] { return g.PrimForest<Heap>().totalCost; });
+}
+
+// Every graph suite except load; file names the input in the report
+static void BenchGraph(BenchContext& ctx, Graph& g, std::string file, const SuiteSet& suites) {
+    if (suites.count("dfs")) {
+        Bench(ctx, "dfs", "iterative", file, 1, [&] {
+            DFSWorkspace ws(0);
+            g.DFS(ws);
+            return (long long)ws.cc;
+        });
+    }
+    if (suites.count("components")) {
+        Bench(ctx, "components", "afforest", file, ctx.threads, [&] {
+            DFSWorkspace ws(0);
+            g.ConnectedComponents(ws, ctx.threads);
+            return (long long)ws.cc;
+        });
+    }
+    if (suites.count("bfs")) {
+        Bench(ctx, "bfs", "queue", file, 1, [&] { return Checksum(g.BFS(1)); });
+        ThreadPool pool(ctx.threads);
+        Bench(ctx, "bfs", "direction", file, ctx.threads, [&] { return Checksum(g.DirectionOptimizingBFS(1, pool)); });
+    }
+    if (suites.count("dijkstra")) {
+        BenchDijkstra<MinHeap>(ctx, g, "binary", file);
+        BenchDijkstra<DaryHeap<4>>(ctx, g, "4-ary", file);
+        BenchDijkstra<DaryHeap<8>>(ctx, g, "8-ary", file);
+        BenchDijkstra<PairingHeap>(ctx, g, "pairing", file);
+        BenchDijkstra<RadixHeap>(ctx, g, "radix", file);
+        Bench(ctx, "dijkstra", "delta", file, ctx.threads, [&] { return Checksum(g.DeltaStepping(1, 0, ctx.threads)); });
+    }
+    if (suites.count("prim")) {
+        BenchPrim<MinHeap>(ctx, g, "binary", file);
+        BenchPrim<DaryHeap<4>>(ctx, g, "4-ary", file);
+        BenchPrim<DaryHeap<8>>(ctx, g, "8-ary", file);
+        BenchPrim<PairingHeap>(ctx, g, "pairing", file);
+        Bench(ctx, "prim", "dense", file, 1, [&] { return g.DensePrimForest().totalCost; });
+    }
+    if (suites.count("mst")) {
+        Bench(ctx, "mst", "kruskal", file, ctx.threads, [&] { return g.Kruskal(ctx.threads); });
+        Bench(ctx, "mst", "boruvka", file, ctx.threads, [&] { return g.Boruvka(ctx.threads); });
+    }
+}
+
+static void BenchFile(BenchContext& ctx, std::string file, const SuiteSet& suites) {
+    if (suites.count("load"))
+        BenchLoad(ctx, file);
+    Graph g = Graph(file, ctx.graphOptions, ctx.threads);
+    BenchGraph(ctx, g, file, suites);
+}
+
+// MakeHeap per element, and DeleteMin, Insert and DecreaseKey per operation, at size 2^logSize.
+// Keys are non-negative and never go below the last minimum so the radix heap can take them
+template <typename Heap>
+static void BenchHeap(BenchContext& ctx, std::string name, int logSize) {
+    int size = 1 << logSize;
+    int ops = std::min(size / 2, 10000);
+    std::string input = std::to_string(size);
+    std::mt19937 rng(logSize);
+    std::vector<Element> elements(size);
+    for (int i = 0; i < size; i++)
+        elements[i] = Element{ i, (int)(rng() % 1000000) };
+
+    Heap* h = NULL;
+    std::vector<int> keys(size);
+    std::vector<int> popped(ops);
+    auto fresh = [&] {
+        delete h;
+        h = new Heap(elements);
+        for (int i = 0; i < size; i++)
+            keys[i] = elements[i].key;
+    };
+
+    Timing t = Measure(ctx.options, [&] { delete h; h = NULL; }, [&] { h = new Heap(elements); }, size);
+    ctx.report.Add(BenchmarkRow{ "heap", name + "/make", input, 1, size, t, 0 });
+
+    t = Measure(ctx.options, fresh, [&] {
+        for (int k = 0; k < ops; k++)
+            h->DeleteMin();
+    }, ops);
+    ctx.report.Add(BenchmarkRow{ "heap", name + "/deletemin", input, 1, ops, t, 0 });
+
+    // Put back what was popped, with keys above every remaining key
+    t = Measure(ctx.options, [&] {
+        fresh();
+        for (int k = 0; k < ops; k++)
+            popped[k] = h->DeleteMin();
+    }, [&] {
+        for (int k = 0; k < ops; k++)
+            h->Insert(Element{ popped[k], 1000000 + popped[k] % 1000 });
+    }, ops);
+    ctx.report.Add(BenchmarkRow{ "heap", name + "/insert", input, 1, ops, t, 0 });
+
+    // Halve the keys of random elements
+    std::vector<int> targets(ops);
+    for (int k = 0; k < ops; k++)
+        targets[k] = rng() % size;
+    t = Measure(ctx.options, fresh, [&] {
+        for (int k = 0; k < ops; k++) {
+            int id = targets[k];
+            keys[id] /= 2;
+            h->DecreaseKey(id, keys[id]);
+        }
+    }, ops);
+    ctx.report.Add(BenchmarkRow{ "heap", name + "/decreasekey", input, 1, ops, t, 0 });
+    delete h;
+}
+
+static void PrintUsage() {
+    std::ostringstream ss;
+    ss << "bench.exe [options] [files...]\n";
+    ss << "-d | Directed graphs\n";
+    ss << "-w | Weighted graphs\n";
+    ss << "-l | Adjacency list storage\n";
+    ss << "-c | Compressed sparse row storage\n";
+    ss << "-t N | Threads for the parallel algorithms, 0 for all cores (default)\n";
+    ss << "-s LIST | Comma separated suites (default " << allSuites << ")\n";
+    ss << "-g model:V:E:seed[:minWeight:maxWeight[:weights]] | Also benchmark a generated graph (er, rmat, grid, complete; uniform, exp or log weights), repeatable\n";
+    ss << "-n MIN:MAX | Heap sizes 2^MIN to 2^MAX (default 10:20)\n";
+    ss << "-r SECONDS | Timed seconds per benchmark before giving up on stability (default 5)\n";
+    ss << "-ci FRACTION | Target 95% confidence interval relative to the mean (default 0.02)\n";
+    ss << "--csv FILE | Write results as CSV\n";
+    ss << "--json FILE | Write results as JSON\n";
+    std::cerr << ss.str() << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+    BenchContext ctx;
+    ctx.graphOptions = 0;
+    ctx.threads = 0;
+    SuiteSet suites;
+    ParseSuites(allSuites, suites);
+    int minLog = 10, maxLog = 20;
+    std::string csvFile, jsonFile;
+    std::vector<std::string> files;
+    std::vector<std::string> generated;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-d") == 0) {
+            ctx.graphOptions |= Directed;
+        } else if (strcmp(argv[i], "-w") == 0) {
+            ctx.graphOptions |= Weighted;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            ctx.graphOptions |= UseList;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            ctx.graphOptions |= UseCSR;
+        } else if (strcmp(argv[i], "-t") == 0 && hasValue) {
+            ctx.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && hasValue) {
+            if (!ParseSuites(argv[++i], suites)) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "-g") == 0 && hasValue) {
+            generated.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%d:%d", &minLog, &maxLog) != 2) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "-r") == 0 && hasValue) {
+            ctx.options.maxSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-ci") == 0 && hasValue) {
+            ctx.options.targetCI = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvFile = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonFile = argv[++i];
+        } else if (argv[i][0] != '-') {
+            files.push_back(argv[i]);
+        } else {
+            std::cerr << "Invalid argument: " << argv[i] << std::endl;
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Report the real thread count
+    if (ctx.threads <= 0)
+        ctx.threads = DefaultThreads();
+
+    for (auto file : files)
+        BenchFile(ctx, file, suites);
+    // Generated graphs are built in memory, so there is nothing to load
+    for (auto spec : generated) {
+        Graph g = GenerateGraph(ParseGeneratorSpec(spec), ctx.graphOptions, ctx.threads);
+        BenchGraph(ctx, g, spec, suites);
+    }
+
+    if (suites.count("heap")) {
+        for (int logSize = minLog; logSize <= maxLog; logSize++) {
+            BenchHeap<MinHeap>(ctx, "binary", logSize);
+            BenchHeap<DaryHeap<4>>(ctx, "4-ary", logSize);
+            BenchHeap<DaryHeap<8>>(ctx, "8-ary", logSize);
+            BenchHeap<PairingHeap>(ctx, "pairing", logSize);
+            BenchHeap<RadixHeap>(ctx, "radix", logSize);
+        }
+    }
+
+    if (!csvFile.empty())
+        ctx.report.WriteCSV(csvFile);
+    if (!jsonFile.empty())
+        ctx.report.WriteJSON(jsonFile);
+    return 0;
+}
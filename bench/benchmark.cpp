@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "benchmark.h"
+
+Timing Summarize(std::vector<double> samples, bool stable) {
+    std::sort(samples.begin(), samples.end());
+    int n = samples.size();
+    double mean = 0;
+    for (double s : samples)
+        mean += s;
+    mean /= n;
+    double variance = 0;
+    for (double s : samples)
+        variance += (s - mean) * (s - mean);
+    variance = n > 1 ? variance / (n - 1) : 0;
+
+    Timing t;
+    t.reps = n;
+    t.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    // Nearest rank
+    t.p99 = samples[std::min(n - 1, (int)std::ceil(0.99 * n) - 1)];
+    t.mean = mean;
+    t.ci95 = 1.96 * std::sqrt(variance) / std::sqrt(n);
+    t.stable = stable;
+    return t;
+}
+
+void BenchmarkReport::Add(const BenchmarkRow& row) {
+    this->rows.push_back(row);
+    std::ostringstream ss;
+    ss << std::left << std::setw(12) << row.suite << std::setw(20) << row.name << std::setw(32) << row.input
+       << " threads " << std::setw(3) << row.threads << std::scientific << std::setprecision(3)
+       << " median " << row.timing.median << " p99 " << row.timing.p99 << " +/- " << row.timing.ci95
+       << " reps " << row.timing.reps << (row.timing.stable ? "" : " (unstable)") << " check " << row.check;
+    std::cout << ss.str() << std::endl;
+}
+
+// Quotes a CSV field that holds a separator, quote or line break, doubling the quotes inside
+static std::string CSVField(const std::string& s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos)
+        return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void BenchmarkReport::WriteCSV(std::string fileName) const {
+    std::ofstream f(fileName);
+    if (!f.good()) {
+        std::cerr << "Error writing file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    f << "suite,name,input,threads,ops,reps,median_s,p99_s,mean_s,ci95_s,stable,check\n";
+    f << std::setprecision(9);
+    for (auto& r : this->rows) {
+        f << CSVField(r.suite) << "," << CSVField(r.name) << "," << CSVField(r.input) << ","
+          << r.threads << "," << r.ops << "," << r.timing.reps << "," << r.timing.median << "," << r.timing.p99 << "," << r.timing.mean << ","
+          << r.timing.ci95 << "," << (r.timing.stable ? 1 : 0) << "," << r.check << "\n";
+    }
+}
+
+// Quotes and escapes a string for JSON
+static std::string Quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (c == '\t') {
+            out += "\\t";
+        } else if (c == '\r') {
+            out += "\\r";
+        } else if ((unsigned char)c < 0x20) {
+            // Other control characters have no short escape
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+void BenchmarkReport::WriteJSON(std::string fileName) const {
+    std::ofstream f(fileName);
+    if (!f.good()) {
+        std::cerr << "Error writing file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    f << "[\n" << std::setprecision(9);
+    for (size_t i = 0; i < this->rows.size(); i++) {
+        const BenchmarkRow& r = this->rows[i];
+        f << "  {\"suite\": " << Quote(r.suite) << ", \"name\": " << Quote(r.name) << ", \"input\": " << Quote(r.input)
+          << ", \"threads\": " << r.threads << ", \"ops\": " << r.ops << ", \"reps\": " << r.timing.reps
+          << ", \"median_s\": " << r.timing.median << ", \"p99_s\": " << r.timing.p99 << ", \"mean_s\": " << r.timing.mean
+          << ", \"ci95_s\": " << r.timing.ci95 << ", \"stable\": " << (r.timing.stable ? "true" : "false")
+          << ", \"check\": " << r.check << "}" << (i + 1 < this->rows.size() ? "," : "") << "\n";
+    }
+    f << "]\n";
+}
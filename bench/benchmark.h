@@ -0,0 +1,90 @@
+#if !defined(BENCHMARK_H)
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// How long to keep repeating a measurement
+struct BenchmarkOptions {
+    int warmup = 2; // Untimed runs before measuring
+    int minReps = 5;
+    int maxReps = 10000;
+    double maxSeconds = 5; // Timed seconds per benchmark before giving up on stability
+    double targetCI = 0.02; // Stop once the 95% confidence interval is within this fraction of the mean
+};
+
+// Summary of the timed runs, in seconds per operation
+struct Timing {
+    int reps;
+    double median;
+    double p99;
+    double mean;
+    double ci95; // Half width of the 95% confidence interval of the mean
+    bool stable; // Whether ci95 reached the target before the rep or time limit
+};
+
+// Orders the samples and computes the summary; samples are seconds per operation
+Timing Summarize(std::vector<double> samples, bool stable);
+
+// Calls setup (untimed) and run (timed) repeatedly: warmup runs first, then until the confidence
+// interval is tight enough or a limit is hit. run covers ops operations, so times are divided by ops
+template <typename Setup, typename Run>
+Timing Measure(const BenchmarkOptions& options, Setup setup, Run run, long long ops = 1) {
+    for (int i = 0; i < options.warmup; i++) {
+        setup();
+        run();
+    }
+
+    std::vector<double> samples;
+    double total = 0, sum = 0, sumSquares = 0;
+    while (true) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        total += elapsed;
+
+        double perOp = elapsed / ops;
+        samples.push_back(perOp);
+        sum += perOp;
+        sumSquares += perOp * perOp;
+
+        int n = samples.size();
+        if (n < options.minReps)
+            continue;
+        double mean = sum / n;
+        double variance = (sumSquares - n * mean * mean) / (n - 1);
+        double ci95 = 1.96 * std::sqrt(variance > 0 ? variance : 0) / std::sqrt(n);
+        bool stable = ci95 <= options.targetCI * mean;
+        if (stable || n >= options.maxReps || total >= options.maxSeconds)
+            return Summarize(samples, stable);
+    }
+}
+
+// One line of the report
+struct BenchmarkRow {
+    std::string suite; // load, dfs, bfs, dijkstra...
+    std::string name; // Variant within the suite, e.g. the heap
+    std::string input; // File name or problem size
+    int threads;
+    long long ops; // Operations per timed run
+    Timing timing;
+    long long check; // Result of the run (cost, reached vertices...) so regressions in output show up too
+};
+
+// Collects rows and writes them as a table, CSV or JSON
+class BenchmarkReport {
+private:
+    std::vector<BenchmarkRow> rows;
+
+public:
+    // Adds the row and prints it as it finishes
+    void Add(const BenchmarkRow& row);
+
+    void WriteCSV(std::string fileName) const;
+    void WriteJSON(std::string fileName) const;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <cstdint>
+#include "graph.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+static const uint64_t noEdge = UINT64_MAX;
+
+// Weight in the high half (order preserving) and edge index in the low half,
+// so every edge has a distinct key and ties break the same way everywhere
+static uint64_t EdgeKey(int weight, uint32_t index) {
+    return (uint64_t)((uint32_t)weight ^ 0x80000000u) << 32 | index;
+}
+
+static void AtomicMin(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+long long Graph::Boruvka(int numThreads) {
+    // Reset
+    this->mst = std::vector<MSTEdge>();
+
+    std::vector<Edge> edges = this->SpanningEdges();
+    ThreadPool pool(numThreads);
+    int numTasks = pool.Size();
+
+    std::vector<std::atomic<int>> parent(this->numV);
+    std::vector<std::atomic<uint64_t>> cheapest(this->numV);
+    for (int v = 0; v < this->numV; v++) {
+        parent[v].store(v, std::memory_order_relaxed);
+        cheapest[v].store(noEdge, std::memory_order_relaxed);
+    }
+    // Indices of edges that still join two components
+    std::vector<uint32_t> live(edges.size());
+    for (size_t i = 0; i < edges.size(); i++)
+        live[i] = i;
+
+    std::vector<std::vector<uint32_t>> added(numTasks);
+    std::vector<std::vector<uint32_t>> kept(numTasks);
+    bool merged = true;
+
+    while (merged && !live.empty()) {
+        // Cheapest edge leaving each component, stored at its root
+        pool.Run(numTasks, [&](int t) {
+            for (size_t i = live.size() * t / numTasks; i < live.size() * (t + 1) / numTasks; i++) {
+                const Edge& e = edges[live[i]];
+                int a = AtomicFind(parent, e.from);
+                int b = AtomicFind(parent, e.to);
+                if (a == b)
+                    continue;
+                uint64_t key = EdgeKey(e.weight, live[i]);
+                AtomicMin(cheapest[a], key);
+                AtomicMin(cheapest[b], key);
+            }
+        });
+
+        // Every component links along its cheapest edge; an edge picked from both
+        // sides only succeeds once
+        pool.Run(numTasks, [&](int t) {
+            for (int v = (long long)this->numV * t / numTasks; v < (long long)this->numV * (t + 1) / numTasks; v++) {
+                uint64_t key = cheapest[v].load(std::memory_order_relaxed);
+                if (key == noEdge)
+                    continue;
+                cheapest[v].store(noEdge, std::memory_order_relaxed);
+                uint32_t index = (uint32_t)key;
+                if (AtomicUnion(parent, edges[index].from, edges[index].to))
+                    added[t].push_back(index);
+            }
+        });
+
+        merged = false;
+        for (auto& list : added) {
+            for (uint32_t index : list) {
+                const Edge& e = edges[index];
+                this->mst.push_back(MSTEdge{ e.from, e.to, e.weight });
+                merged = true;
+            }
+            list.clear();
+        }
+
+        // Drop edges that now sit inside one component
+        pool.Run(numTasks, [&](int t) {
+            for (size_t i = live.size() * t / numTasks; i < live.size() * (t + 1) / numTasks; i++) {
+                const Edge& e = edges[live[i]];
+                if (AtomicFind(parent, e.from) != AtomicFind(parent, e.to))
+                    kept[t].push_back(live[i]);
+            }
+        });
+        live.clear();
+        for (auto& list : kept) {
+            live.insert(live.end(), list.begin(), list.end());
+            list.clear();
+        }
+    }
+
+    long long totalCost = 0;
+    for (auto e : this->mst)
+        totalCost += e.weight;
+    this->mstCost = totalCost;
+    this->IndexMST();
+    return totalCost;
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include "graph.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+// Afforest: link every vertex to its first few neighbors, find the component most
+// vertices already fell into, then finish the rest while skipping that component
+static const int neighborRounds = 2;
+static const int numSamples = 1024;
+
+// Most common root among a sample of vertices
+static int LargestComponent(std::vector<std::atomic<int>>& parent) {
+    std::mt19937 rng(27491095);
+    std::uniform_int_distribution<int> pick(0, parent.size() - 1);
+    std::vector<int> roots(numSamples);
+    for (int& root : roots)
+        root = AtomicFind(parent, pick(rng));
+    std::sort(roots.begin(), roots.end());
+
+    int best = roots[0];
+    int bestCount = 0;
+    for (size_t i = 0; i < roots.size();) {
+        size_t j = i;
+        while (j < roots.size() && roots[j] == roots[i])
+            j++;
+        if ((int)(j - i) > bestCount) {
+            bestCount = j - i;
+            best = roots[i];
+        }
+        i = j;
+    }
+    return best;
+}
+
+void Graph::ConnectedComponents(DFSWorkspace& ws, int numThreads) const {
+    ws = DFSWorkspace(this->numV);
+    if (this->numV == 0)
+        return;
+
+    ThreadPool pool(numThreads);
+    int numTasks = pool.Size();
+    std::vector<std::atomic<int>> parent(this->numV);
+    for (int v = 0; v < this->numV; v++)
+        parent[v].store(v, std::memory_order_relaxed);
+    auto forEachVertex = [&](auto visit) {
+        pool.Run(numTasks, [&](int t) {
+            for (int v = (long long)this->numV * t / numTasks; v < (long long)this->numV * (t + 1) / numTasks; v++)
+                visit(v);
+        });
+    };
+
+    // Where each vertex's neighbor scan stopped, so the last phase picks up from there
+    std::vector<int> cursor(this->numV, 0);
+    for (int round = 0; round < neighborRounds; round++) {
+        forEachVertex([&](int v) {
+            int to;
+            if (this->NextNeighbor(v, cursor[v], to))
+                AtomicUnion(parent, v, to);
+        });
+    }
+
+    // A vertex in the largest component only has edges into it when the graph is undirected,
+    // since its neighbors link back from their own side. Directed edges are only seen from
+    // their source, so then every vertex finishes its scan
+    int skip = this->opts & Directed ? -1 : LargestComponent(parent);
+    forEachVertex([&](int v) {
+        if (AtomicFind(parent, v) == skip)
+            return;
+        int to;
+        while (this->NextNeighbor(v, cursor[v], to))
+            AtomicUnion(parent, v, to);
+    });
+
+    // Roots are the smallest vertex of their set, so numbering roots in index order gives each
+    // component the number DFS would: the order of its first vertex
+    for (int v = 0; v < this->numV; v++) {
+        int root = AtomicFind(parent, v);
+        if (root == v) {
+            ws.cc++;
+            ws.component[v] = ws.cc;
+        } else {
+            ws.component[v] = ws.component[root];
+        }
+    }
+}
+
+void Graph::ConnectedComponents(int numThreads) {
+    DFSWorkspace ws(this->numV);
+    this->ConnectedComponents(ws, numThreads);
+    for (int i = 0; i < this->numV; i++)
+        this->vertices[i].component = ws.component[i];
+}
@@ -0,0 +1,187 @@
+#if !defined(D_ARY_HEAP_H)
+#define D_ARY_HEAP_H
+
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include "min_heap.h"
+#include "stats.h"
+
+// Indexed min heap where every node has D children; same interface as MinHeap.
+// A wider node makes the tree shallower, so DecreaseKey/Insert do fewer moves
+// while DeleteMin compares more children per level.
+// Elements are stored as ID/key pairs, shifted so the D children of a node
+// start on a cache line boundary; with D = 8 a whole sibling group is one line.
+template <int D>
+class DaryHeap {
+private:
+    static const int lineBytes = 64;
+
+    int capacity; // Max size
+    int size; // Current size
+    std::vector<Element> storage; // Backing array, over-allocated for alignment
+    int shift; // Heap index i lives at storage[shift + i]
+    std::vector<int> indices; // Map data ID to index
+
+    Element& At(int idx) { return this->storage[this->shift + idx]; }
+    int Parent(int idx) { return (idx - 1) / D; }
+    int FirstChild(int idx) { return D * idx + 1; }
+
+    // Allocates storage and picks the shift that aligns child groups
+    void Allocate();
+    // Place element at position index and let the heap bubble up
+    void BubbleUp(Element e, int index);
+    // Place element at position index and let the heap sift down
+    void SiftDown(Element e, int index);
+    // Returns the index of the smallest child of heap[index], 0 if none
+    int MinChild(int index);
+
+public:
+    // Empty heap with specified capacity
+    DaryHeap(int capacity);
+    // Intialize heap from existing array
+    DaryHeap(std::vector<Element> arr);
+
+    int Size() { return this->size; }
+
+    void Insert(Element el);
+    void DecreaseKey(int ID, int newKey);
+    // Return -1 if no elements
+    int DeleteMin();
+    // Returns the index of the element, -1 if not found
+    int Index(int ID);
+};
+
+template <int D>
+DaryHeap<D>::DaryHeap(int capacity)
+    : capacity(capacity), size(0), indices(capacity, -1) {
+    this->Allocate();
+}
+
+template <int D>
+DaryHeap<D>::DaryHeap(std::vector<Element> arr)
+    : capacity(arr.size()), size(arr.size()), indices(arr.size()) {
+    this->Allocate();
+    for (int i = 0; i < this->capacity; i++) {
+        this->At(i) = arr[i];
+        this->indices[arr[i].ID] = i;
+    }
+    for (int i = this->size - 1; i >= 0; i--) {
+        this->SiftDown(this->At(i), i);
+    }
+}
+
+template <int D>
+void DaryHeap<D>::Allocate() {
+    // Child groups are D * sizeof(Element) bytes; align them to that, up to a cache line
+    int groupBytes = D * sizeof(Element) < lineBytes ? D * sizeof(Element) : lineBytes;
+    int slack = groupBytes / sizeof(Element);
+    this->storage = std::vector<Element>(this->capacity + slack);
+    // Index 1 is the first child of the root; find the shift that puts it on a boundary
+    this->shift = 0;
+    while (this->shift < slack &&
+        reinterpret_cast<uintptr_t>(&this->storage[this->shift + 1]) % groupBytes != 0) {
+        this->shift++;
+    }
+}
+
+template <int D>
+void DaryHeap<D>::Insert(Element el) {
+    if (this->size == this->capacity) {
+        // Full
+        std::cout << "error: cannot insert; heap is full" << std::endl;
+        return;
+    }
+    this->size++;
+    this->BubbleUp(el, this->size - 1);
+}
+
+template <int D>
+void DaryHeap<D>::DecreaseKey(int ID, int newKey) {
+    // Don't do anything if ID was popped
+    if (this->Index(ID) == -1)
+        return;
+    int index = this->Index(ID);
+    this->BubbleUp(Element{ ID, newKey }, index);
+    if constexpr (collectStats) {
+        Stats().decreaseKeys++;
+        Stats().decreaseKeysMoved += this->Index(ID) != index;
+    }
+}
+
+template <int D>
+int DaryHeap<D>::DeleteMin() {
+    if (this->size == 0) {
+        // Empty
+        std::cout << "error: cannot delete min; heap is empty" << std::endl;
+        return -1;
+    }
+    int ID = this->At(0).ID;
+    this->size--;
+    if (this->size > 0)
+        this->SiftDown(this->At(this->size), 0);
+    this->indices[ID] = -1;
+    return ID;
+}
+
+template <int D>
+int DaryHeap<D>::Index(int ID) {
+    if (ID < this->capacity) {
+        return this->indices[ID];
+    }
+    return -1;
+}
+
+template <int D>
+void DaryHeap<D>::BubbleUp(Element e, int index) {
+    while (index > 0) {
+        int p = this->Parent(index);
+        if (this->At(p).key <= e.key)
+            break;
+        this->At(index) = this->At(p);
+        this->indices[this->At(index).ID] = index;
+        index = p;
+        if constexpr (collectStats)
+            Stats().bubbleUpLevels++;
+    }
+    this->At(index) = e;
+    this->indices[e.ID] = index;
+    if constexpr (collectStats)
+        Stats().bubbleUps++;
+}
+
+template <int D>
+void DaryHeap<D>::SiftDown(Element e, int index) {
+    int c = this->MinChild(index);
+    while (c > 0 && this->At(c).key < e.key) {
+        this->At(index) = this->At(c);
+        this->indices[this->At(index).ID] = index;
+        index = c;
+        c = this->MinChild(index);
+        if constexpr (collectStats)
+            Stats().siftDownLevels++;
+    }
+    this->At(index) = e;
+    this->indices[e.ID] = index;
+    if constexpr (collectStats)
+        Stats().siftDowns++;
+}
+
+template <int D>
+int DaryHeap<D>::MinChild(int index) {
+    int first = this->FirstChild(index);
+    if (first >= this->size)
+        return 0;
+    int last = min(first + D, this->size);
+    int best = first;
+    int bestKey = this->At(first).key;
+    for (int c = first + 1; c < last; c++) {
+        if (this->At(c).key < bestKey) {
+            best = c;
+            bestKey = this->At(c).key;
+        }
+    }
+    return best;
+}
+
+#endif // D_ARY_HEAP_H
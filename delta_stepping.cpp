@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "graph.h"
+#include "thread_pool.h"
+
+// Distance in the high half and predecessor + 1 in the low half, so one
+// compare-and-swap updates both and "no predecessor" (-1) packs lowest
+static uint64_t Pack(int distance, int prev) {
+    return (uint64_t)(uint32_t)distance << 32 | (uint32_t)(prev + 1);
+}
+
+static int Distance(uint64_t packed) {
+    return packed >> 32;
+}
+
+static int Prev(uint64_t packed) {
+    return (int)(uint32_t)packed - 1;
+}
+
+ShortestPathResult Graph::DeltaStepping(int startVertexIndex, int delta, int numThreads) const {
+    // Correct for 1 indexing
+    startVertexIndex--;
+
+    ThreadPool pool(numThreads);
+    int numTasks = pool.Size();
+
+    long long numEdges = 0;
+    int maxWeight = 1;
+    for (int v = 0; v < this->numV; v++) {
+        this->ForEachNeighbor(v, [&](int, int weight) {
+            numEdges++;
+            if (weight > maxWeight)
+                maxWeight = weight;
+        });
+    }
+    // Pick delta from the weights: max weight over the average degree
+    if (delta <= 0) {
+        double avgDegree = this->numV > 0 ? (double)numEdges / this->numV : 1;
+        delta = avgDegree > 1 ? maxWeight / avgDegree : maxWeight;
+        if (delta < 1)
+            delta = 1;
+    }
+    // Any delta gives the right distances, so a tiny one against large weights is widened
+    // rather than allocating a bucket per unit of weight
+    const int maxBuckets = 1 << 16;
+    if ((maxWeight + (long long)delta - 1) / delta + 1 > maxBuckets)
+        delta = (maxWeight + maxBuckets - 2) / (maxBuckets - 1);
+
+    std::vector<std::atomic<uint64_t>> dist(this->numV);
+    for (auto& d : dist)
+        d.store(Pack(INT32_MAX, -1), std::memory_order_relaxed);
+    // Distance each vertex had when its edges were last relaxed
+    std::vector<int> expandedAt(this->numV, INT32_MAX);
+    std::vector<bool> settled(this->numV, false);
+
+    // Relaxing a vertex of bucket i lands at most ceil(maxWeight / delta) buckets later, so a cyclic
+    // array one longer than that holds every live bucket; bucket i lives at i % buckets.size()
+    std::vector<std::vector<int>> buckets((maxWeight + (long long)delta - 1) / delta + 1);
+    size_t queued = 0; // Entries over all buckets, stale ones included
+    // Vertices improved by each task during a relaxation round
+    std::vector<std::vector<int>> improved(numTasks);
+
+    dist[startVertexIndex].store(Pack(0, -1));
+    buckets[0].push_back(startVertexIndex);
+    queued++;
+
+    // Relaxes either the light (weight <= delta) or heavy edges of every vertex in the list
+    auto relaxAll = [&](const std::vector<int>& list, bool light) {
+        // Small deltas leave most buckets empty; don't wake the pool for them
+        if (list.empty())
+            return;
+        pool.Run(numTasks, [&](int t) {
+            size_t first = list.size() * t / numTasks;
+            size_t last = list.size() * (t + 1) / numTasks;
+            for (size_t i = first; i < last; i++) {
+                int from = list[i];
+                int fromDist = Distance(dist[from].load(std::memory_order_relaxed));
+                this->ForEachNeighbor(from, [&](int to, int weight) {
+                    if ((weight <= delta) != light)
+                        return;
+                    // Paths too long for an int stay unreachable
+                    long long newDist = std::min((long long)fromDist + weight, (long long)INT32_MAX);
+                    uint64_t candidate = Pack(newDist, from);
+                    uint64_t current = dist[to].load(std::memory_order_relaxed);
+                    // Only a strictly shorter distance replaces the predecessor; ties broken on the
+                    // predecessor could link zero weight edges into a cycle in prev
+                    while (Distance(candidate) < Distance(current)) {
+                        if (dist[to].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                            improved[t].push_back(to);
+                            break;
+                        }
+                    }
+                });
+            }
+        });
+        // Move improved vertices into the bucket of their new distance
+        for (auto& list : improved) {
+            for (int v : list) {
+                size_t b = Distance(dist[v].load(std::memory_order_relaxed)) / delta;
+                buckets[b % buckets.size()].push_back(v);
+                queued++;
+            }
+            list.clear();
+        }
+    };
+
+    for (size_t i = 0; queued > 0; i++) {
+        std::vector<int>& bucket = buckets[i % buckets.size()];
+        // Every vertex settled in this bucket, for the heavy edge pass
+        std::vector<int> removed;
+        while (!bucket.empty()) {
+            // Drop entries that moved to another bucket or were already expanded at this distance
+            std::vector<int> frontier;
+            for (int v : bucket) {
+                int d = Distance(dist[v].load(std::memory_order_relaxed));
+                if ((size_t)(d / delta) != i || d >= expandedAt[v])
+                    continue;
+                expandedAt[v] = d;
+                frontier.push_back(v);
+                if (!settled[v]) {
+                    settled[v] = true;
+                    removed.push_back(v);
+                }
+            }
+            queued -= bucket.size();
+            bucket.clear();
+            // Light edges can land back in this bucket, so repeat until it stays empty
+            relaxAll(frontier, true);
+        }
+        // Heavy edges always land in a later bucket, so once is enough
+        relaxAll(removed, false);
+        // Live entries all sit within one turn of the array, so skip straight to the next one
+        while (queued > 0 && buckets[(i + 1) % buckets.size()].empty())
+            i++;
+    }
+
+    ShortestPathResult result(startVertexIndex, this->numV);
+    for (int v = 0; v < this->numV; v++) {
+        uint64_t packed = dist[v].load(std::memory_order_relaxed);
+        result.distance[v] = Distance(packed);
+        result.prev[v] = Prev(packed);
+    }
+    return result;
+}
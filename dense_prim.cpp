@@ -0,0 +1,159 @@
+#include <climits>
+#include "graph.h"
+#include "perf_counters.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX2_PATH 1
+#endif
+
+// keys[j] holds the cheapest known edge into j, INT_MAX once j is in the tree or unreached.
+// inTree[j] is -1 for tree vertices and 0 otherwise so it can be used as a vector mask
+
+// Index of the smallest key, -1 if every key is INT_MAX
+static int MinKey(const int* keys, int n) {
+    int best = -1;
+    int bestKey = INT_MAX;
+    for (int j = 0; j < n; j++) {
+        if (keys[j] < bestKey) {
+            bestKey = keys[j];
+            best = j;
+        }
+    }
+    return best;
+}
+
+// Lowers keys of non-tree vertices that have a cheaper edge from cur
+static void RelaxRow(const int* row, int* keys, int* parent, const int* inTree, int n, int cur) {
+    for (int j = 0; j < n; j++) {
+        // Zero means no edge
+        if (row[j] != 0 && !inTree[j] && row[j] < keys[j]) {
+            keys[j] = row[j];
+            parent[j] = cur;
+        }
+    }
+}
+
+#if defined(HAVE_AVX2_PATH)
+__attribute__((target("avx2")))
+static int MinKeyAVX2(const int* keys, int n) {
+    __m256i best = _mm256_set1_epi32(INT_MAX);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        best = _mm256_min_epi32(best, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + j)));
+    }
+    // Fold the 8 lanes down to one
+    __m128i half = _mm_min_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int bestKey = _mm_cvtsi128_si32(half);
+    for (; j < n; j++) {
+        if (keys[j] < bestKey)
+            bestKey = keys[j];
+    }
+    if (bestKey == INT_MAX)
+        return -1;
+
+    // First lane holding the minimum
+    __m256i target = _mm256_set1_epi32(bestKey);
+    for (j = 0; j + 8 <= n; j += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(target, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + j)));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask != 0)
+            return j + __builtin_ctz(mask);
+    }
+    for (; j < n; j++) {
+        if (keys[j] == bestKey)
+            return j;
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+static void RelaxRowAVX2(const int* row, int* keys, int* parent, const int* inTree, int n, int cur) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i from = _mm256_set1_epi32(cur);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j));
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + j));
+        __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inTree + j));
+        // Edge exists, target not in the tree, and the edge is cheaper than its key
+        __m256i skip = _mm256_or_si256(_mm256_cmpeq_epi32(w, zero), t);
+        __m256i better = _mm256_andnot_si256(skip, _mm256_cmpgt_epi32(k, w));
+        if (_mm256_testz_si256(better, better))
+            continue;
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(parent + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(keys + j), _mm256_blendv_epi8(k, w, better));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(parent + j), _mm256_blendv_epi8(p, from, better));
+    }
+    RelaxRow(row + j, keys + j, parent + j, inTree + j, n - j, cur);
+}
+#endif
+
+bool Graph::IsDense() const {
+    if (this->opts & (UseCSR | UseList) || this->UseBits())
+        return false;
+    return this->numE * 4 >= (long long)this->numV * this->numV;
+}
+
+SpanningForest Graph::DensePrimForest() const {
+    if (this->opts & (UseCSR | UseList) || this->UseBits())
+        return this->PrimForest<MinHeap>();
+
+    SpanningForest forest(this->numV);
+    std::vector<int> keys(this->numV, INT_MAX);
+    std::vector<int> inTree(this->numV, 0);
+    std::vector<int> parent(this->numV, -1);
+    // Where to look for the next tree root once everything reachable is in the tree
+    int nextRoot = 0;
+
+    bool avx2 = false;
+#if defined(HAVE_AVX2_PATH)
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    PERF_BEGIN(PhaseSearch);
+    for (int added = 0; added < this->numV; added++) {
+        // The key scan stands in for DeleteMin
+        PERF_BEGIN(PhaseDeleteMin);
+        int curr;
+#if defined(HAVE_AVX2_PATH)
+        curr = avx2 ? MinKeyAVX2(keys.data(), this->numV) : MinKey(keys.data(), this->numV);
+#else
+        curr = MinKey(keys.data(), this->numV);
+#endif
+        PERF_END(PhaseDeleteMin);
+        if (curr == -1) {
+            // Nothing reaches the rest, so start the next tree
+            while (inTree[nextRoot])
+                nextRoot++;
+            curr = nextRoot;
+            forest.componentCosts.push_back(0);
+        } else {
+            forest.parent[curr] = parent[curr];
+            forest.weight[curr] = keys[curr];
+            forest.componentCosts.back() += keys[curr];
+        }
+        forest.component[curr] = forest.componentCosts.size() - 1;
+        inTree[curr] = -1;
+        keys[curr] = INT_MAX;
+
+        PERF_BEGIN(PhaseRelax);
+        const int* row = this->adjacencies[curr].data();
+#if defined(HAVE_AVX2_PATH)
+        if (avx2)
+            RelaxRowAVX2(row, keys.data(), parent.data(), inTree.data(), this->numV, curr);
+        else
+            RelaxRow(row, keys.data(), parent.data(), inTree.data(), this->numV, curr);
+#else
+        RelaxRow(row, keys.data(), parent.data(), inTree.data(), this->numV, curr);
+#endif
+        PERF_END(PhaseRelax);
+    }
+    PERF_END(PhaseSearch);
+
+    for (long long cost : forest.componentCosts)
+        forest.totalCost += cost;
+    return forest;
+}
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include "graph.h"
+
+bool Graph::EdgeWeight(int from, int to, int& weight) const {
+    // Parallel edges report the lightest copy, the one shortest paths and the MST use
+    bool found = false;
+    if (this->opts & UseCSR) {
+        for (int e = this->csrOffsets[from]; e < this->csrOffsets[from + 1]; e++) {
+            if (this->csrTo[e] == to && (!found || this->csrWeights[e] < weight)) {
+                weight = this->csrWeights[e];
+                found = true;
+            }
+        }
+        return found;
+    } else if (this->opts & UseList) {
+        for (auto e : this->adjacencyList[from]) {
+            if (e.to == to && (!found || e.weight < weight)) {
+                weight = e.weight;
+                found = true;
+            }
+        }
+        return found;
+    } else if (this->UseBits()) {
+        weight = 1;
+        return this->BitRow(from)[to / 64] >> (to % 64) & 1;
+    } else {
+        // Zero means no edge
+        weight = this->adjacencies[from][to];
+        return weight != 0;
+    }
+}
+
+int Graph::SetEdge(int from, int to, int weight) {
+    // Parallel copies collapse into the first one, which takes the new weight
+    if (this->opts & UseCSR) {
+        int removed = this->EraseEdge(from, to, 1);
+        for (int e = this->csrOffsets[from]; e < this->csrOffsets[from + 1]; e++) {
+            if (this->csrTo[e] == to) {
+                this->csrWeights[e] = weight;
+                return -removed;
+            }
+        }
+        // Open a slot at the end of the row and shift every later row over it
+        int e = this->csrOffsets[from + 1];
+        this->csrTo.insert(this->csrTo.begin() + e, to);
+        this->csrWeights.insert(this->csrWeights.begin() + e, weight);
+        for (int v = from + 1; v <= this->numV; v++)
+            this->csrOffsets[v]++;
+        return 1;
+    } else if (this->opts & UseList) {
+        int removed = this->EraseEdge(from, to, 1);
+        for (auto& e : this->adjacencyList[from]) {
+            if (e.to == to) {
+                e.weight = weight;
+                return -removed;
+            }
+        }
+        this->adjacencyList[from].push_back(ListEdge{ to, weight });
+        return 1;
+    } else if (this->UseBits()) {
+        uint64_t& word = this->adjacencyBits[(size_t)from * this->bitWords + to / 64];
+        uint64_t bit = (uint64_t)1 << (to % 64);
+        bool had = word & bit;
+        word |= bit;
+        return had ? 0 : 1;
+    } else {
+        bool had = this->adjacencies[from][to] != 0;
+        this->adjacencies[from][to] = weight;
+        return had ? 0 : 1;
+    }
+}
+
+int Graph::EraseEdge(int from, int to, int keep) {
+    if (this->opts & UseCSR) {
+        // Compact the row over the erased copies, then shift the later rows down once
+        int first = this->csrOffsets[from];
+        int last = this->csrOffsets[from + 1];
+        int kept = first;
+        int seen = 0;
+        for (int e = first; e < last; e++) {
+            if (this->csrTo[e] != to || seen++ < keep) {
+                this->csrTo[kept] = this->csrTo[e];
+                this->csrWeights[kept] = this->csrWeights[e];
+                kept++;
+            }
+        }
+        int removed = last - kept;
+        if (removed == 0)
+            return 0;
+        this->csrTo.erase(this->csrTo.begin() + kept, this->csrTo.begin() + last);
+        this->csrWeights.erase(this->csrWeights.begin() + kept, this->csrWeights.begin() + last);
+        for (int v = from + 1; v <= this->numV; v++)
+            this->csrOffsets[v] -= removed;
+        return removed;
+    } else if (this->opts & UseList) {
+        std::vector<ListEdge>& list = this->adjacencyList[from];
+        size_t before = list.size();
+        int seen = 0;
+        list.erase(std::remove_if(list.begin(), list.end(), [&](const ListEdge& e) { return e.to == to && seen++ >= keep; }), list.end());
+        return before - list.size();
+    } else if (keep > 0) {
+        // Matrices hold at most one copy
+        return 0;
+    } else if (this->UseBits()) {
+        uint64_t& word = this->adjacencyBits[(size_t)from * this->bitWords + to / 64];
+        uint64_t bit = (uint64_t)1 << (to % 64);
+        bool had = word & bit;
+        word &= ~bit;
+        return had ? 1 : 0;
+    } else {
+        bool had = this->adjacencies[from][to] != 0;
+        this->adjacencies[from][to] = 0;
+        return had ? 1 : 0;
+    }
+}
+
+bool Graph::AddEdge(int from, int to, int weight) {
+    if (!this->IsVertex(from) || !this->IsVertex(to))
+        return false;
+    // Weighted matrices have no way to store a weight 0 edge
+    bool weightedMatrix = (this->opts & Weighted) && !(this->opts & (UseList | UseCSR));
+    if (weightedMatrix && weight == 0)
+        return false;
+    // Correct for 1 indexing
+    from--;
+    to--;
+    if (!(this->opts & Weighted))
+        weight = 1;
+
+    int oldWeight;
+    bool existed = this->EdgeWeight(from, to, oldWeight);
+    this->numE += this->SetEdge(from, to, weight);
+    // Also do reverse
+    bool reverse = !(this->opts & Directed) && from != to;
+    if (reverse)
+        this->numE += this->SetEdge(to, from, weight);
+    this->reverseEdges = std::make_shared<ReverseEdgesCache>();
+
+    if (this->opts & Directed)
+        this->DropMST();
+
+    if (existed) {
+        // Same as changing the weight
+        if (this->mstCurrent && weight != oldWeight) {
+            int index = this->FindInMST(from, to);
+            if (index == -1) {
+                if (weight < oldWeight)
+                    this->InsertIntoMST(from, to, weight);
+            } else {
+                this->mstCost += weight - oldWeight;
+                this->mst[index].weight = weight;
+                if (weight > oldWeight)
+                    this->ReplaceInMST(index);
+            }
+        }
+        return true;
+    }
+
+    if (this->componentsCurrent)
+        this->componentSets.Union(from, to);
+    if (this->mstCurrent)
+        this->InsertIntoMST(from, to, weight);
+    return true;
+}
+
+bool Graph::RemoveEdge(int from, int to) {
+    if (!this->IsVertex(from) || !this->IsVertex(to))
+        return false;
+    // Correct for 1 indexing
+    from--;
+    to--;
+    int removed = this->EraseEdge(from, to);
+    if (removed == 0)
+        return false;
+    // Also do reverse
+    bool reverse = !(this->opts & Directed) && from != to;
+    if (reverse)
+        removed += this->EraseEdge(to, from);
+    this->reverseEdges = std::make_shared<ReverseEdgesCache>();
+
+    this->numE -= removed;
+    // Union-find can't split sets
+    this->componentsCurrent = false;
+    if (this->opts & Directed)
+        this->DropMST();
+    if (this->mstCurrent) {
+        int index = this->FindInMST(from, to);
+        if (index != -1)
+            this->ReplaceInMST(index);
+    }
+    return true;
+}
+
+bool Graph::UpdateWeight(int from, int to, int weight) {
+    int oldWeight;
+    if (!this->IsVertex(from) || !this->IsVertex(to) || !this->EdgeWeight(from - 1, to - 1, oldWeight))
+        return false;
+    return this->AddEdge(from, to, weight);
+}
+
+bool Graph::Connected(int a, int b) {
+    if (!this->componentsCurrent) {
+        this->componentSets = UnionFind(this->numV);
+        for (int v = 0; v < this->numV; v++) {
+            this->ForEachNeighbor(v, [&](int to, int) { this->componentSets.Union(v, to); });
+        }
+        this->componentsCurrent = true;
+    }
+    if (!this->IsVertex(a) || !this->IsVertex(b))
+        return false;
+    // Correct for 1 indexing
+    return this->componentSets.Find(a - 1) == this->componentSets.Find(b - 1);
+}
+
+int Graph::NumComponents() {
+    // Brings the sets up to date
+    this->Connected(1, 1);
+    return this->componentSets.NumSets();
+}
+
+void Graph::DropMST() {
+    this->mst = std::vector<MSTEdge>();
+    this->mstAdjacency = std::vector<std::vector<std::pair<int, int>>>();
+    this->mstCost = 0;
+    this->mstCurrent = false;
+}
+
+void Graph::IndexMST() {
+    this->mstAdjacency = std::vector<std::vector<std::pair<int, int>>>(this->numV);
+    for (size_t i = 0; i < this->mst.size(); i++) {
+        this->mstAdjacency[this->mst[i].from].push_back(std::make_pair(this->mst[i].to, (int)i));
+        this->mstAdjacency[this->mst[i].to].push_back(std::make_pair(this->mst[i].from, (int)i));
+    }
+    this->mstCurrent = true;
+}
+
+void Graph::AddToMST(const MSTEdge& e) {
+    int index = this->mst.size();
+    this->mst.push_back(e);
+    this->mstAdjacency[e.from].push_back(std::make_pair(e.to, index));
+    this->mstAdjacency[e.to].push_back(std::make_pair(e.from, index));
+}
+
+// Points the adjacency entry of the edge at v from index to newIndex, or removes it if newIndex is -1
+static void Relink(std::vector<std::pair<int, int>>& adjacent, int index, int newIndex) {
+    for (size_t i = 0; i < adjacent.size(); i++) {
+        if (adjacent[i].second == index) {
+            if (newIndex == -1) {
+                adjacent[i] = adjacent.back();
+                adjacent.pop_back();
+            } else {
+                adjacent[i].second = newIndex;
+            }
+            return;
+        }
+    }
+}
+
+void Graph::RemoveFromMST(int index) {
+    MSTEdge removed = this->mst[index];
+    Relink(this->mstAdjacency[removed.from], index, -1);
+    Relink(this->mstAdjacency[removed.to], index, -1);
+    int last = this->mst.size() - 1;
+    if (index != last) {
+        MSTEdge moved = this->mst[last];
+        Relink(this->mstAdjacency[moved.from], last, index);
+        Relink(this->mstAdjacency[moved.to], last, index);
+        this->mst[index] = moved;
+    }
+    this->mst.pop_back();
+}
+
+int Graph::FindInMST(int from, int to) const {
+    for (auto next : this->mstAdjacency[from]) {
+        if (next.first == to)
+            return next.second;
+    }
+    return -1;
+}
+
+void Graph::SearchMST(int from, std::vector<int>& parentEdge) const {
+    parentEdge = std::vector<int>(this->numV, -2);
+    parentEdge[from] = -1;
+    std::vector<int> stack{ from };
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        for (auto next : this->mstAdjacency[v]) {
+            if (parentEdge[next.first] == -2) {
+                parentEdge[next.first] = next.second;
+                stack.push_back(next.first);
+            }
+        }
+    }
+}
+
+void Graph::InsertIntoMST(int from, int to, int weight) {
+    if (from == to)
+        return;
+
+    std::vector<int> parentEdge;
+    this->SearchMST(from, parentEdge);
+    if (parentEdge[to] == -2) {
+        // Joins two trees
+        this->AddToMST(MSTEdge{ from, to, weight });
+        this->mstCost += weight;
+        return;
+    }
+
+    // Heaviest edge on the tree path from to back to from
+    int heaviest = -1;
+    for (int v = to; v != from;) {
+        const MSTEdge& e = this->mst[parentEdge[v]];
+        if (heaviest == -1 || e.weight > this->mst[heaviest].weight)
+            heaviest = parentEdge[v];
+        v = e.from == v ? e.to : e.from;
+    }
+    if (weight < this->mst[heaviest].weight) {
+        this->mstCost += weight - this->mst[heaviest].weight;
+        this->RemoveFromMST(heaviest);
+        this->AddToMST(MSTEdge{ from, to, weight });
+    }
+}
+
+void Graph::ReplaceInMST(int index) {
+    MSTEdge cut = this->mst[index];
+    this->RemoveFromMST(index);
+    this->mstCost -= cut.weight;
+
+    // Everything still attached to one end is one side of the cut
+    std::vector<int> parentEdge;
+    this->SearchMST(cut.from, parentEdge);
+    bool found = false;
+    MSTEdge best = cut;
+    for (int v = 0; v < this->numV; v++) {
+        if (parentEdge[v] == -2)
+            continue;
+        this->ForEachNeighbor(v, [&](int to, int weight) {
+            if (parentEdge[to] == -2 && (!found || weight < best.weight)) {
+                best = MSTEdge{ v, to, weight };
+                found = true;
+            }
+        });
+    }
+    if (found) {
+        this->AddToMST(best);
+        this->mstCost += best.weight;
+    }
+}
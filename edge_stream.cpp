@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include "edge_stream.h"
+#include "text_parse.h"
+#include "union_find.h"
+
+// Text read from the file at a time
+static const size_t readBytes = 1 << 20;
+
+EdgeStream::EdgeStream(std::string fileName, unsigned char options, size_t memoryBytes)
+    : file(fileName, std::ios::binary), labeled(false), numV(0), opts(options), lineNumber(0),
+      buffer(readBytes), pos(0), filled(0), bufferOffset(0), edgesOffset(0) {
+    if (!this->file) {
+        std::cerr << "Could not open " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    this->chunkEdges = std::max(memoryBytes / sizeof(Edge), (size_t)1);
+    this->ReadHeader();
+}
+
+bool EdgeStream::NextLine(const char*& line, const char*& lineEnd) {
+    while (true) {
+        const char* begin = this->buffer.data() + this->pos;
+        const char* end = this->buffer.data() + this->filled;
+        const char* nl = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        if (nl != NULL || (this->file.eof() && begin < end)) {
+            line = begin;
+            lineEnd = nl == NULL ? end : nl + 1;
+            this->pos = lineEnd - this->buffer.data();
+            return true;
+        }
+        if (this->file.eof())
+            return false;
+
+        // Keep the partial line and read after it, growing for lines longer than the buffer
+        size_t rest = this->filled - this->pos;
+        std::copy(this->buffer.begin() + this->pos, this->buffer.begin() + this->filled, this->buffer.begin());
+        this->bufferOffset += this->pos;
+        this->pos = 0;
+        this->filled = rest;
+        if (this->buffer.size() - rest < readBytes / 2)
+            this->buffer.resize(this->buffer.size() * 2);
+        this->file.read(this->buffer.data() + rest, this->buffer.size() - rest);
+        this->filled += this->file.gcount();
+    }
+}
+
+void EdgeStream::ReadHeader() {
+    const char* line = NULL;
+    const char* end = NULL;
+
+    // First line: number of vertices
+    while (this->NextLine(line, end) && IsSkippedLine(line, end)) {}
+    this->numV = ParseInt(line, end);
+
+    // Optional labels
+    std::streamoff start = this->bufferOffset + this->pos;
+    while (this->NextLine(line, end) && IsSkippedLine(line, end))
+        start = this->bufferOffset + this->pos;
+    if (line < end && *line == '-') {
+        this->labeled = true;
+        while (this->NextLine(line, end)) {
+            if (IsSkippedLine(line, end))
+                continue;
+            // Termination of labels
+            if (*line == '-')
+                break;
+            std::string label = ParseToken(line, end);
+            int num = ParseInt(line, end);
+            // Labels are 1-indexed like vertex numbers
+            this->labels[label] = num - 1;
+        }
+        start = this->bufferOffset + this->pos;
+    }
+    this->edgesOffset = start;
+    this->Rewind();
+}
+
+void EdgeStream::Rewind() {
+    this->file.clear();
+    this->file.seekg(this->edgesOffset);
+    this->bufferOffset = this->edgesOffset;
+    this->pos = 0;
+    this->filled = 0;
+    this->lineNumber = 1;
+}
+
+bool EdgeStream::NextChunk(std::vector<Edge>& chunk) {
+    chunk.clear();
+    // Exactly one chunk, rather than whatever push_back doubling would round up to
+    chunk.reserve(this->chunkEdges);
+    const char* line;
+    const char* end;
+    while (chunk.size() < this->chunkEdges && this->NextLine(line, end)) {
+        if (IsSkippedLine(line, end))
+            continue;
+
+        this->lineNumber++;
+        Edge e;
+        if (this->labeled) {
+            e.from = this->labels.at(ParseToken(line, end));
+            e.to = this->labels.at(ParseToken(line, end));
+        } else if (ParseInt(line, end, e.from) && ParseInt(line, end, e.to)) {
+            // Account for 1-indexing
+            e.from--;
+            e.to--;
+        } else {
+            e.from = e.to = -1;
+        }
+        e.weight = 1;
+        if (this->opts & Weighted && HasValue(line, end)) {
+            e.weight = ParseInt(line, end);
+        }
+        // Catch bad input errors
+        if (e.from < 0 || e.from >= this->numV || e.to < 0 || e.to >= this->numV) {
+            std::cerr << "Vertex missing or out of range @ line " << this->lineNumber << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        chunk.push_back(e);
+    }
+    return !chunk.empty();
+}
+
+std::vector<int> StreamComponents(EdgeStream& stream) {
+    int numV = stream.NumVertices();
+    UnionFind sets(numV);
+    std::vector<Edge> chunk;
+    stream.Rewind();
+    while (stream.NextChunk(chunk)) {
+        for (auto e : chunk)
+            sets.Union(e.from, e.to);
+    }
+
+    // Number each set when its lowest vertex is reached
+    std::vector<int> component(numV);
+    std::vector<int> number(numV, -1);
+    int cc = 0;
+    for (int v = 0; v < numV; v++) {
+        int root = sets.Find(v);
+        if (number[root] == -1)
+            number[root] = ++cc;
+        component[v] = number[root];
+    }
+    return component;
+}
+
+// Runs merged at once; more would exhaust file handles and shrink the read buffers
+static const size_t mergeFanIn = 16;
+
+// A sorted run of edges in a temporary file, read back through a small buffer
+struct EdgeRun {
+    FILE* file;
+    std::vector<Edge> buffer;
+    size_t pos;
+    size_t filled;
+
+    // Refills the buffer once it is used up, false when the run is done
+    bool Fill() {
+        if (this->pos < this->filled)
+            return true;
+        this->filled = fread(this->buffer.data(), sizeof(Edge), this->buffer.size(), this->file);
+        this->pos = 0;
+        return this->filled > 0;
+    }
+};
+
+static FILE* NewRunFile() {
+    FILE* f = tmpfile();
+    if (f == NULL) {
+        std::cerr << "Could not create a temporary file for edge runs" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return f;
+}
+
+// Appends edges to a run; a short write (usually a full temporary disk) would lose edges and give a wrong MST
+static void WriteRun(FILE* f, const Edge* edges, size_t count) {
+    if (fwrite(edges, sizeof(Edge), count, f) != count) {
+        std::cerr << "Could not write an edge run to a temporary file" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Flushes a finished run so buffered write errors show up before it is read back
+static void FinishRun(FILE* f) {
+    if (fflush(f) != 0 || ferror(f)) {
+        std::cerr << "Could not write an edge run to a temporary file" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Merges the runs in weight order, closing them, and calls emit(edge) until it returns false.
+// bufferEdges is shared between the read buffers of all runs
+template <typename F>
+static void MergeRuns(const std::vector<FILE*>& files, size_t bufferEdges, F emit) {
+    std::vector<EdgeRun> runs;
+    size_t runEdges = std::max(bufferEdges / std::max(files.size(), (size_t)1), (size_t)1);
+    typedef std::pair<int, size_t> Head; // Weight of a run's next edge, run index
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t r = 0; r < files.size(); r++) {
+        rewind(files[r]);
+        runs.push_back(EdgeRun{ files[r], std::vector<Edge>(runEdges), 0, 0 });
+        if (runs[r].Fill())
+            heads.push(Head{ runs[r].buffer[0].weight, r });
+    }
+
+    while (!heads.empty()) {
+        size_t r = heads.top().second;
+        EdgeRun& run = runs[r];
+        heads.pop();
+        if (!emit(run.buffer[run.pos++]))
+            break;
+        if (run.Fill())
+            heads.push(Head{ run.buffer[run.pos].weight, r });
+    }
+
+    for (auto& run : runs)
+        fclose(run.file);
+}
+
+long long StreamKruskal(EdgeStream& stream, std::vector<MSTEdge>& mst) {
+    mst = std::vector<MSTEdge>();
+    std::vector<Edge> chunk;
+    // levels[k] holds runs built from mergeFanIn^k chunks; a full level is merged into the next one
+    std::vector<std::vector<FILE*>> levels(1);
+    stream.Rewind();
+
+    // Sort each chunk by weight and spill it; self loops never join anything
+    while (stream.NextChunk(chunk)) {
+        chunk.erase(std::remove_if(chunk.begin(), chunk.end(), [](const Edge& e) { return e.from == e.to; }), chunk.end());
+        // In place, since stable_sort would take a second chunk's worth of buffer; ties are broken on the
+        // vertices so the runs don't depend on the sort
+        std::sort(chunk.begin(), chunk.end(), [](const Edge& a, const Edge& b) {
+            if (a.weight != b.weight)
+                return a.weight < b.weight;
+            return a.from != b.from ? a.from < b.from : a.to < b.to;
+        });
+        FILE* f = NewRunFile();
+        WriteRun(f, chunk.data(), chunk.size());
+        FinishRun(f);
+        levels[0].push_back(f);
+
+        for (size_t k = 0; levels[k].size() == mergeFanIn; k++) {
+            // The merge buffers take the chunk's memory, so release it; the next NextChunk allocates it again
+            std::vector<Edge>().swap(chunk);
+            FILE* merged = NewRunFile();
+            MergeRuns(levels[k], stream.ChunkEdges(), [&](const Edge& e) {
+                WriteRun(merged, &e, 1);
+                return true;
+            });
+            FinishRun(merged);
+            levels[k].clear();
+            if (k + 1 == levels.size())
+                levels.emplace_back();
+            levels[k + 1].push_back(merged);
+        }
+    }
+    // Release the chunk before the merge buffers take its memory
+    std::vector<Edge>().swap(chunk);
+
+    // Whatever is left is at most mergeFanIn - 1 runs per level. Merge the smallest (lowest level) runs
+    // until at most mergeFanIn remain, then take the cheapest edges that join two trees
+    std::vector<FILE*> runs;
+    for (auto& level : levels)
+        runs.insert(runs.end(), level.begin(), level.end());
+    while (runs.size() > mergeFanIn) {
+        // Just enough runs that the last merge leaves exactly mergeFanIn
+        size_t count = std::min(mergeFanIn, runs.size() - mergeFanIn + 1);
+        std::vector<FILE*> smallest(runs.begin(), runs.begin() + count);
+        FILE* merged = NewRunFile();
+        MergeRuns(smallest, stream.ChunkEdges(), [&](const Edge& e) {
+            WriteRun(merged, &e, 1);
+            return true;
+        });
+        FinishRun(merged);
+        runs.erase(runs.begin(), runs.begin() + count);
+        runs.push_back(merged);
+    }
+    UnionFind sets(stream.NumVertices());
+    long long totalCost = 0;
+    MergeRuns(runs, stream.ChunkEdges(), [&](const Edge& e) {
+        if (sets.Union(e.from, e.to)) {
+            mst.push_back(MSTEdge{ e.from, e.to, e.weight });
+            totalCost += e.weight;
+        }
+        return sets.NumSets() > 1;
+    });
+    return totalCost;
+}
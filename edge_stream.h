@@ -0,0 +1,58 @@
+#if !defined(EDGE_STREAM_H)
+#define EDGE_STREAM_H
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+// Reads the edges of a graph text file a chunk at a time, for graphs too large to store.
+// Only the vertex count, labels and one chunk of edges are held in memory
+class EdgeStream {
+private:
+    std::ifstream file;
+    std::map<std::string, int> labels;
+    bool labeled;
+    int numV;
+    unsigned char opts; // Directed and Weighted are used
+    size_t chunkEdges; // Edges handed out per chunk
+    int lineNumber;
+
+    // Raw text read from the file; [pos, filled) is not parsed yet
+    std::vector<char> buffer;
+    size_t pos;
+    size_t filled;
+    std::streamoff bufferOffset; // File offset of buffer[0]
+    std::streamoff edgesOffset; // File offset of the first edge line, for Rewind
+
+    // Sets [line, lineEnd) to the next line, reading more of the file when needed; false at end of file
+    bool NextLine(const char*& line, const char*& lineEnd);
+    void ReadHeader();
+
+public:
+    // memoryBytes bounds the edges held at once, both here and in the streaming algorithms:
+    // StreamKruskal holds either one chunk or the read buffers of one merge, never both
+    EdgeStream(std::string fileName, unsigned char options, size_t memoryBytes = (size_t)64 << 20);
+
+    int NumVertices() const { return this->numV; }
+    size_t ChunkEdges() const { return this->chunkEdges; }
+
+    // Replaces chunk with the next edges of the file (0-indexed), false once every edge has been read
+    bool NextChunk(std::vector<Edge>& chunk);
+    // Starts again from the first edge, for algorithms that take several passes
+    void Rewind();
+};
+
+// Semi-streaming connected components: one pass over the edges with a union-find, O(V) memory.
+// Components are numbered from 1 in order of their lowest vertex, the same numbering DFS gives.
+// Directed edges are followed both ways, giving weakly connected components
+std::vector<int> StreamComponents(EdgeStream& stream);
+
+// Kruskal over edges that don't fit in memory. Each chunk is sorted by weight and spilled to a
+// temporary file as a run, runs are merged 16 at a time, and the final merge of at most 16 runs feeds a union-find.
+// Directed edges are treated as undirected. Returns the cost of the minimum spanning forest and fills mst
+long long StreamKruskal(EdgeStream& stream, std::vector<MSTEdge>& mst);
+
+#endif // EDGE_STREAM_H
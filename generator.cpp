@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include "generator.h"
+
+// Number of distinct edges the model could have at most
+static long long MaxEdges(const GeneratorOptions& options) {
+    long long n = options.numV;
+    return options.directed ? n * (n - 1) : n * (n - 1) / 2;
+}
+
+// Undirected pairs are stored smaller vertex first so (u, v) and (v, u) are the same edge; also the sort order
+static uint64_t PairKey(int from, int to) {
+    return (uint64_t)from << 32 | (uint32_t)to;
+}
+
+static std::vector<Edge> CompleteEdges(const GeneratorOptions& options) {
+    std::vector<Edge> edges;
+    edges.reserve(MaxEdges(options));
+    for (int from = 0; from < options.numV; from++) {
+        for (int to = options.directed ? 0 : from + 1; to < options.numV; to++) {
+            if (from != to)
+                edges.push_back(Edge{ from, to, 1 });
+        }
+    }
+    return edges;
+}
+
+static std::vector<Edge> GridEdges(const GeneratorOptions& options) {
+    // As square as possible; the last row may be partial
+    int cols = std::max(1, (int)std::ceil(std::sqrt((double)options.numV)));
+    std::vector<Edge> edges;
+    edges.reserve(2 * (size_t)options.numV);
+    for (int v = 0; v < options.numV; v++) {
+        if ((v + 1) % cols != 0 && v + 1 < options.numV)
+            edges.push_back(Edge{ v, v + 1, 1 });
+        if (v + cols < options.numV)
+            edges.push_back(Edge{ v, v + cols, 1 });
+    }
+    return edges;
+}
+
+// Draws pairs until numE distinct ones are found, giving up after drawAttempts draws per edge
+static const long long drawAttempts = 64;
+
+// Duplicates are removed by sorting the edges themselves, so the only memory is the edges
+// (a hash set of pairs takes several times that at 10^7 vertices). Draws come in rounds sized
+// from how many of the last round's were new, at most numE per round, and the survivors are
+// shuffled back into a random order at the end
+template <typename Draw>
+static std::vector<Edge> SampleEdges(const GeneratorOptions& options, std::mt19937_64& rng, Draw draw) {
+    std::vector<Edge> edges;
+    long long draws = 0;
+    long long maxDraws = drawAttempts * options.numE;
+    double newRate = 1; // Fraction of the last round's draws that were new pairs
+    while ((long long)edges.size() < options.numE && draws < maxDraws) {
+        long long need = options.numE - edges.size();
+        long long round = std::min((long long)std::min(need / newRate * 1.1 + 16, (double)options.numE), maxDraws - draws);
+        size_t before = edges.size();
+        edges.reserve(before + round);
+        for (long long i = 0; i < round; i++) {
+            int from, to;
+            draw(from, to);
+            if (from == to)
+                continue;
+            if (!options.directed && from > to)
+                std::swap(from, to);
+            edges.push_back(Edge{ from, to, 1 });
+        }
+        draws += round;
+
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return PairKey(a.from, a.to) < PairKey(b.from, b.to); });
+        edges.erase(std::unique(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.from == b.from && a.to == b.to; }), edges.end());
+        newRate = std::max((double)(edges.size() - before) / round, 1e-3);
+    }
+    edges.shrink_to_fit();
+
+    for (size_t i = 0; i + 1 < edges.size(); i++) {
+        std::uniform_int_distribution<size_t> pick(i, edges.size() - 1);
+        std::swap(edges[i], edges[pick(rng)]);
+    }
+    if ((long long)edges.size() > options.numE)
+        edges.resize(options.numE);
+    return edges;
+}
+
+std::vector<Edge> GenerateEdges(const GeneratorOptions& options) {
+    std::mt19937_64 rng(options.seed);
+    std::vector<Edge> edges;
+
+    if (options.model == Complete || (options.model != Grid && options.numE >= MaxEdges(options))) {
+        edges = CompleteEdges(options);
+    } else if (options.model == Grid) {
+        edges = GridEdges(options);
+    } else if (options.model == ErdosRenyi && options.numE * 2 > MaxEdges(options)) {
+        // Dense: rejection would keep hitting taken pairs, so shuffle every pair and keep a prefix
+        edges = CompleteEdges(options);
+        for (long long i = 0; i < options.numE; i++) {
+            std::uniform_int_distribution<long long> pick(i, edges.size() - 1);
+            std::swap(edges[i], edges[pick(rng)]);
+        }
+        edges.resize(options.numE);
+    } else if (options.model == ErdosRenyi) {
+        std::uniform_int_distribution<int> vertex(0, options.numV - 1);
+        edges = SampleEdges(options, rng, [&](int& from, int& to) {
+            from = vertex(rng);
+            to = vertex(rng);
+        });
+    } else {
+        // R-MAT: pick a quadrant of the 2^scale square adjacency matrix per bit of the vertex numbers
+        int scale = 0;
+        while ((1LL << scale) < options.numV)
+            scale++;
+        std::uniform_real_distribution<double> unit(0, 1);
+        edges = SampleEdges(options, rng, [&](int& from, int& to) {
+            do {
+                from = 0;
+                to = 0;
+                for (int bit = 0; bit < scale; bit++) {
+                    double r = unit(rng);
+                    bool down = r >= options.a + options.b;
+                    bool right = (r >= options.a && r < options.a + options.b) || r >= options.a + options.b + options.c;
+                    from = from << 1 | down;
+                    to = to << 1 | right;
+                }
+            } while (from >= options.numV || to >= options.numV);
+        });
+    }
+
+    // Skewed weights are offsets from minWeight, in doubles so a full int range can't overflow
+    double range = (double)options.maxWeight - options.minWeight;
+    if (options.weights == ExponentialWeights) {
+        std::exponential_distribution<double> offset(10 / (range + 1));
+        for (auto& e : edges) {
+            double x;
+            do {
+                x = std::floor(offset(rng));
+            } while (x > range);
+            e.weight = (int)(options.minWeight + x);
+        }
+    } else if (options.weights == LogUniformWeights) {
+        // exp() lands in [1, range + 2), so offsets cover [0, range]
+        std::uniform_real_distribution<double> logOffset(0, std::log(range + 2));
+        for (auto& e : edges) {
+            double x = std::min(std::floor(std::exp(logOffset(rng))) - 1, range);
+            e.weight = (int)(options.minWeight + x);
+        }
+    } else {
+        std::uniform_int_distribution<int> weight(options.minWeight, options.maxWeight);
+        for (auto& e : edges)
+            e.weight = weight(rng);
+    }
+    return edges;
+}
+
+Graph GenerateGraph(const GeneratorOptions& generator, unsigned char options, int numThreads) {
+    options = generator.directed ? options | Directed : options & ~Directed;
+    return Graph(generator.numV, GenerateEdges(generator), options, numThreads);
+}
+
+void WriteGraph(std::string fileName, int numV, const std::vector<Edge>& edges, bool weighted) {
+    std::ofstream f(fileName);
+    if (!f.good()) {
+        std::cerr << "Error writing file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    f << numV << "\n";
+    for (auto e : edges) {
+        // Account for 1-indexing
+        f << e.from + 1 << " " << e.to + 1;
+        if (weighted)
+            f << " " << e.weight;
+        f << "\n";
+    }
+}
+
+// Prints the problem and the spec format, then exits
+static void SpecError(const std::string& spec, const std::string& problem) {
+    std::cerr << problem << " in generator spec " << spec << "\n"
+              << "Expected model:V:E:seed[:minWeight:maxWeight[:weights]], model er, rmat, grid or complete, "
+              << "weights uniform, exp or log" << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+// Whole string as a decimal number in [low, high]
+static long long ParseSpecNumber(const std::string& spec, const std::string& text, long long low, long long high, const char* name) {
+    size_t used = 0;
+    long long value = 0;
+    try {
+        value = std::stoll(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (text.empty() || used != text.size())
+        SpecError(spec, std::string("Bad ") + name + " '" + text + "'");
+    if (value < low || value > high)
+        SpecError(spec, std::string(name) + " out of range");
+    return value;
+}
+
+GeneratorOptions ParseGeneratorSpec(std::string spec) {
+    std::vector<std::string> parts;
+    std::istringstream ss(spec);
+    std::string part;
+    while (getline(ss, part, ':'))
+        parts.push_back(part);
+
+    GeneratorOptions options;
+    if (parts.size() != 4 && parts.size() != 6 && parts.size() != 7)
+        SpecError(spec, "Wrong number of fields");
+    if (parts[0] == "er") {
+        options.model = ErdosRenyi;
+    } else if (parts[0] == "rmat") {
+        options.model = RMAT;
+    } else if (parts[0] == "grid") {
+        options.model = Grid;
+    } else if (parts[0] == "complete") {
+        options.model = Complete;
+    } else {
+        SpecError(spec, "Unknown graph model " + parts[0]);
+    }
+    options.numV = ParseSpecNumber(spec, parts[1], 1, INT32_MAX, "vertex count");
+    options.numE = ParseSpecNumber(spec, parts[2], 0, LLONG_MAX, "edge count");
+    options.seed = ParseSpecNumber(spec, parts[3], 0, LLONG_MAX, "seed");
+    if (parts.size() >= 6) {
+        options.minWeight = ParseSpecNumber(spec, parts[4], INT32_MIN, INT32_MAX, "minWeight");
+        options.maxWeight = ParseSpecNumber(spec, parts[5], INT32_MIN, INT32_MAX, "maxWeight");
+        if (options.minWeight > options.maxWeight)
+            SpecError(spec, "minWeight above maxWeight");
+    }
+    if (parts.size() == 7) {
+        if (parts[6] == "uniform")
+            options.weights = UniformWeights;
+        else if (parts[6] == "exp")
+            options.weights = ExponentialWeights;
+        else if (parts[6] == "log")
+            options.weights = LogUniformWeights;
+        else
+            SpecError(spec, "Unknown weight distribution " + parts[6]);
+    }
+    return options;
+}
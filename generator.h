@@ -0,0 +1,55 @@
+#if !defined(GENERATOR_H)
+#define GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+enum GraphModel {
+    ErdosRenyi, // numE distinct edges chosen uniformly at random
+    RMAT, // numE distinct edges placed by recursive quadrant choice, skewed degrees like web/social graphs
+    Grid, // 2D lattice, each vertex joined to its right and lower neighbor; numE is ignored
+    Complete, // Every pair of vertices; numE is ignored
+};
+
+// How edge weights spread over [minWeight, maxWeight]
+enum WeightDistribution {
+    UniformWeights,
+    ExponentialWeights, // Most weights near minWeight, mean about a tenth of the range above it; the rest redrawn
+    LogUniformWeights, // Uniform in log(weight - minWeight + 1), so every order of magnitude is equally likely
+};
+
+struct GeneratorOptions {
+    GraphModel model = ErdosRenyi;
+    int numV = 1000;
+    long long numE = 8000;
+    bool directed = false; // Directed models draw ordered pairs, undirected ones each pair once
+    // Weights are drawn from [minWeight, maxWeight]
+    int minWeight = 1;
+    int maxWeight = 100;
+    WeightDistribution weights = UniformWeights;
+    uint64_t seed = 1; // Same options and seed always give the same edges in the same order
+    // R-MAT quadrant probabilities; the fourth is 1 - a - b - c
+    double a = 0.57;
+    double b = 0.19;
+    double c = 0.19;
+};
+
+// Edges of a synthetic graph, 0-indexed and without self loops or duplicates.
+// Asking for more edges than the model allows gives every possible edge. R-MAT concentrates
+// edges on few vertices, so when nearly all of its draws repeat it stops short of numE
+std::vector<Edge> GenerateEdges(const GeneratorOptions& options);
+
+// Builds the graph in memory without going through a file; options are the Graph storage flags
+Graph GenerateGraph(const GeneratorOptions& generator, unsigned char options, int numThreads = 0);
+
+// Writes the edges in the text input format, with weights if weighted is set
+void WriteGraph(std::string fileName, int numV, const std::vector<Edge>& edges, bool weighted);
+
+// Parses model:V:E:seed[:minWeight:maxWeight[:weights]], model being er, rmat, grid or complete and
+// weights uniform (default), exp or log. Exits with the spec format on a malformed number, V < 1, E < 0
+// or minWeight > maxWeight
+GeneratorOptions ParseGeneratorSpec(std::string spec);
+
+#endif // GENERATOR_H
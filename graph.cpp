@@ -1,11 +1,100 @@
 #include <vector>
 #include <queue>
 #include <sstream>
+#include <cstring>
 #include "graph.h"
+#include "mapped_file.h"
+#include "perf_counters.h"
+#include "stats.h"
+#include "text_parse.h"
+#include "thread_pool.h"
 #include "min_heap.h"
+#include "d_ary_heap.h"
+#include "pairing_heap.h"
+#include "radix_heap.h"
+
+Graph::Graph(std::string fileName, unsigned char options, int numThreads)
+    : labeled(false), bitWords(0), mstCost(0), mstCurrent(false), componentSets(0), componentsCurrent(false),
+      opts(options), numThreads(numThreads) {
+    PERF_SCOPE(PhaseLoad);
+    if (IsSnapshot(fileName)) {
+        if (!this->ReadBinary(fileName))
+            exit(EXIT_FAILURE);
+        this->numE = this->CountEdges();
+        return;
+    }
+
+    // Edges for CSR storage are collected first and packed once all of them are known
+    std::vector<Edge> edges;
+    if (options & (FastLoad | ParallelLoad)) {
+        this->ReadMapped(fileName, edges);
+    } else {
+        this->ReadStream(fileName, edges);
+    }
+
+    // The parallel reader packs CSR storage itself
+    if (options & UseCSR && this->csrOffsets.empty()) {
+        this->BuildCSR(edges);
+    }
+    this->numE = this->CountEdges();
+}
+
+Graph::Graph(int numV, const std::vector<Edge>& edges, unsigned char options, int numThreads)
+    : labeled(false), bitWords(0), mstCost(0), mstCurrent(false), componentSets(0), componentsCurrent(false),
+      opts(options), numThreads(numThreads) {
+    PERF_SCOPE(PhaseLoad);
+    this->InitVertices(numV);
+    this->InitStorage();
+
+    std::vector<Edge> csrEdges;
+    if (options & UseCSR)
+        csrEdges.reserve(options & Directed ? edges.size() : 2 * edges.size());
+    for (auto e : edges) {
+        // Unweighted graphs read every weight as 1
+        this->StoreEdge(e.from, e.to, options & Weighted ? e.weight : 1, csrEdges);
+    }
+    if (options & UseCSR)
+        this->BuildCSR(csrEdges);
+    this->numE = this->CountEdges();
+}
+
+long long Graph::CountEdges() const {
+    long long count = 0;
+    if (this->opts & UseCSR) {
+        count = this->csrTo.size();
+    } else if (this->opts & UseList) {
+        for (auto& list : this->adjacencyList)
+            count += list.size();
+    } else if (this->UseBits()) {
+        for (uint64_t bits : this->adjacencyBits)
+            count += __builtin_popcountll(bits);
+    } else {
+        for (auto& row : this->adjacencies) {
+            for (int weight : row)
+                count += weight != 0;
+        }
+    }
+    return count;
+}
 
-Graph::Graph(std::string fileName, unsigned char options)
-    : labeled(false), opts(options) {
+int Graph::OutDegree(int vertexIndex) const {
+    if (this->opts & UseCSR)
+        return this->csrOffsets[vertexIndex + 1] - this->csrOffsets[vertexIndex];
+    if (this->opts & UseList)
+        return this->adjacencyList[vertexIndex].size();
+    int degree = 0;
+    if (this->UseBits()) {
+        const uint64_t* row = this->BitRow(vertexIndex);
+        for (int w = 0; w < this->bitWords; w++)
+            degree += __builtin_popcountll(row[w]);
+    } else {
+        for (int weight : this->adjacencies[vertexIndex])
+            degree += weight != 0;
+    }
+    return degree;
+}
+
+void Graph::ReadStream(std::string fileName, std::vector<Edge>& edges) {
     std::ifstream f;
     f.open(fileName);
     // Check if file exists
@@ -24,20 +113,7 @@ Graph::Graph(std::string fileName, unsigned char options)
         else
             break;
     }
-    this->numV = std::stoi(line);
-    // Initialize vertex storage
-    this->vertices = std::vector<Vertex>(numV);
-    for (int i = 0; i < this->numV; i++) {
-        this->vertices[i] = Vertex{
-            "",
-            i,
-        false,
-            0,
-            0,
-            0,
-            // std::vector<DistancePath>(this->numV, DistancePath{})
-        };
-    }
+    this->InitVertices(std::stoi(line));
 
     // Read optional labels
     auto pos = f.tellg();
@@ -56,25 +132,14 @@ Graph::Graph(std::string fileName, unsigned char options)
             int num;
             std::istringstream ss(line);
             ss >> label >> num;
-            // 1 indexing
-            num--;
-            // Add to map
-            this->labels.insert(std::pair<std::string, int>(label, num));
-            this->vertices[num].label = label;
+            this->AddLabel(label, num);
         }
     } else {
         // Go back a line
         f.seekg(pos);
     }
 
-
-    if (options & UseList) {
-        // Initialize adjacency matrix to all 0s
-        this->adjacencyList = std::vector<std::vector<ListEdge>>(this->numV, std::vector<ListEdge>());
-    } else {
-        // Initialize adjacency matrix to all 0s
-        this->adjacencies = std::vector<std::vector<int>>(this->numV, std::vector<int>(this->numV));
-    }
+    this->InitStorage();
 
     while (getline(f, line)) {
         // Skip comments
@@ -91,92 +156,449 @@ Graph::Graph(std::string fileName, unsigned char options)
             from = this->labels.at(fromLabel);
             to = this->labels.at(toLabel);
         } else {
-            // Get vertex numbers for the edge
+            // Get vertex numbers for the edge, -1 for each one missing
+            from = to = 0;
             ss >> from >> to;
             // Account for 1-indexing
             from--;
             to--;
         }
         // Catch bad input errors
-        if (from >= this->numV || to >= this->numV) {
-            std::cerr << "Not enough vertices provided @ line " << lineNumber << std::endl;
+        if (from < 0 || from >= this->numV || to < 0 || to >= this->numV) {
+            std::cerr << "Vertex missing or out of range @ line " << lineNumber << std::endl;
             exit(EXIT_FAILURE);
         }
         // Set weight
         int weight = 1;
-        if (options & Weighted) {
+        if (this->opts & Weighted) {
             ss >> weight;
         }
 
-        if (options & UseList) {
-            // Set in list
-            this->adjacencyList[from].push_back(ListEdge{ to, weight });
-            // Also do reverse 
-            if (options ^ Directed) {
-                this->adjacencyList[to].push_back(ListEdge{ from, weight });
+        this->StoreEdge(from, to, weight, edges);
+    }
+
+    f.close();
+}
+
+void Graph::ReadMapped(std::string fileName, std::vector<Edge>& edges) {
+    MappedFile file(fileName);
+    const char* p = file.Begin();
+    const char* end = file.End();
+
+    // Get first line: number of vertices
+    while (p < end && IsSkippedLine(p, end))
+        p = NextLine(p, end);
+    this->InitVertices(ParseInt(p, end));
+    p = NextLine(p, end);
+
+    // Read optional labels
+    if (p < end && *p == '-') {
+        this->labeled = true;
+        p = NextLine(p, end);
+        while (p < end) {
+            if (IsSkippedLine(p, end)) {
+                p = NextLine(p, end);
+                continue;
             }
-        } else {
-            // Set in matrix
-            this->adjacencies[from][to] = weight;
-            // Also do reverse 
-            if (options ^ Directed) {
-                this->adjacencies[to][from] = weight;
+            // Termination of labels
+            if (*p == '-') {
+                p = NextLine(p, end);
+                break;
             }
+            std::string label = ParseToken(p, end);
+            int num = ParseInt(p, end);
+            this->AddLabel(label, num);
+            p = NextLine(p, end);
         }
     }
 
-    f.close();
+    this->InitStorage();
+
+    if (this->opts & ParallelLoad) {
+        this->ParseEdgesParallel(p, end, edges);
+        return;
+    }
+
+    // First pass: count edge lines so storage is sized once
+    if (this->opts & UseCSR) {
+        size_t numEdges = 0;
+        for (const char* q = p; q < end; q = NextLine(q, end)) {
+            if (!IsSkippedLine(q, end))
+                numEdges++;
+        }
+        edges.reserve(this->opts & Directed ? numEdges : 2 * numEdges);
+    }
+
+    int lineNumber = 1;
+    while (p < end) {
+        if (IsSkippedLine(p, end)) {
+            p = NextLine(p, end);
+            continue;
+        }
+
+        lineNumber++;
+        Edge e;
+        // Catch bad input errors
+        if (!this->ParseEdgeLine(p, end, e)) {
+            std::cerr << "Vertex missing or out of range @ line " << lineNumber << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        this->StoreEdge(e.from, e.to, e.weight, edges);
+        p = NextLine(p, end);
+    }
 }
 
-Graph::~Graph() {}
+bool Graph::ParseEdgeLine(const char* p, const char* end, Edge& e) const {
+    if (this->labeled) {
+        e.from = this->labels.at(ParseToken(p, end));
+        e.to = this->labels.at(ParseToken(p, end));
+    } else {
+        if (!ParseInt(p, end, e.from) || !ParseInt(p, end, e.to))
+            return false;
+        // Account for 1-indexing
+        e.from--;
+        e.to--;
+    }
+    // Set weight
+    e.weight = 1;
+    if (this->opts & Weighted && HasValue(p, end)) {
+        e.weight = ParseInt(p, end);
+    }
+    return e.from >= 0 && e.from < this->numV && e.to >= 0 && e.to < this->numV;
+}
+
+void Graph::ParseEdgesParallel(const char* p, const char* end, std::vector<Edge>& edges) {
+    ThreadPool pool(this->numThreads);
+    int numChunks = pool.Size();
+
+    // Split the edge section into chunks that start at the beginning of a line
+    std::vector<const char*> bounds(numChunks + 1);
+    bounds[0] = p;
+    bounds[numChunks] = end;
+    for (int c = 1; c < numChunks; c++) {
+        const char* guess = p + (end - p) * c / numChunks;
+        bounds[c] = guess <= bounds[c - 1] ? bounds[c - 1] : NextLine(guess - 1, end);
+    }
 
-void Graph::Explore(int vertexIndex) {
-    this->vertices[vertexIndex].visited = true;
-    this->Previsit(vertexIndex);
+    // Each chunk parses into its own buffer, remembering where the first bad line was
+    std::vector<std::vector<Edge>> chunks(numChunks);
+    std::vector<const char*> errors(numChunks, NULL);
+    pool.Run(numChunks, [&](int c) {
+        // Pool threads count under load too; each thread has its own counters
+        PERF_SCOPE(PhaseLoad);
+        const char* q = bounds[c];
+        const char* chunkEnd = bounds[c + 1];
+        while (q < chunkEnd) {
+            if (!IsSkippedLine(q, chunkEnd)) {
+                Edge e;
+                if (!this->ParseEdgeLine(q, chunkEnd, e)) {
+                    errors[c] = q;
+                    return;
+                }
+                chunks[c].push_back(e);
+            }
+            q = NextLine(q, chunkEnd);
+        }
+    });
+
+    for (int c = 0; c < numChunks; c++) {
+        if (errors[c] == NULL)
+            continue;
+        // Line numbers only matter when reporting, so count them now
+        int lineNumber = 1;
+        for (const char* q = p; q <= errors[c]; q = NextLine(q, end)) {
+            if (!IsSkippedLine(q, end))
+                lineNumber++;
+        }
+        std::cerr << "Vertex missing or out of range @ line " << lineNumber << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (this->opts & UseCSR) {
+        this->BuildCSRParallel(chunks, pool);
+        return;
+    }
+    // Chunks are in file order, so storage ends up the same as a sequential read
+    for (auto& chunk : chunks) {
+        for (auto e : chunk) {
+            this->StoreEdge(e.from, e.to, e.weight, edges);
+        }
+        std::vector<Edge>().swap(chunk);
+    }
+}
+
+void Graph::InitVertices(int numV) {
+    this->numV = numV;
+    // Initialize vertex storage
+    this->vertices = std::vector<Vertex>(numV);
     for (int i = 0; i < this->numV; i++) {
-        if (this->adjacencies[vertexIndex][i] != 0 && !this->vertices[i].visited) {
-            this->Explore(i);
+        this->vertices[i] = Vertex{
+            "",
+            i,
+        false,
+            0,
+            0,
+            0,
+        };
+    }
+}
+
+void Graph::AddLabel(std::string label, int num) {
+    // 1 indexing
+    num--;
+    // Add to map
+    this->labels.insert(std::pair<std::string, int>(label, num));
+    this->vertices[num].label = label;
+}
+
+void Graph::InitStorage() {
+    if (this->opts & UseCSR) {
+        // Nothing to initialize
+    } else if (this->opts & UseList) {
+        // Initialize adjacency matrix to all 0s
+        this->adjacencyList = std::vector<std::vector<ListEdge>>(this->numV, std::vector<ListEdge>());
+    } else if (this->UseBits()) {
+        // One contiguous all 0 bit matrix, rows padded to whole words
+        this->bitWords = (this->numV + 63) / 64;
+        this->adjacencyBits = std::vector<uint64_t>((size_t)this->numV * this->bitWords, 0);
+    } else {
+        // Initialize adjacency matrix to all 0s
+        this->adjacencies = std::vector<std::vector<int>>(this->numV, std::vector<int>(this->numV));
+    }
+}
+
+void Graph::StoreEdge(int from, int to, int weight, std::vector<Edge>& edges) {
+    // An undirected self loop is stored once, as in the matrices and AddEdge
+    bool reverse = !(this->opts & Directed) && from != to;
+    if (this->opts & UseCSR) {
+        edges.push_back(Edge{ from, to, weight });
+        // Also do reverse 
+        if (reverse) {
+            edges.push_back(Edge{ to, from, weight });
+        }
+    } else if (this->opts & UseList) {
+        // Set in list
+        this->adjacencyList[from].push_back(ListEdge{ to, weight });
+        // Also do reverse 
+        if (reverse) {
+            this->adjacencyList[to].push_back(ListEdge{ from, weight });
+        }
+    } else if (this->UseBits()) {
+        // Set in bit matrix, the weight is always 1
+        this->adjacencyBits[(size_t)from * this->bitWords + to / 64] |= (uint64_t)1 << (to % 64);
+        // Also do reverse 
+        if (reverse) {
+            this->adjacencyBits[(size_t)to * this->bitWords + from / 64] |= (uint64_t)1 << (from % 64);
+        }
+    } else {
+        // Set in matrix
+        this->adjacencies[from][to] = weight;
+        // Also do reverse 
+        if (reverse) {
+            this->adjacencies[to][from] = weight;
         }
     }
-    this->Postvisit(vertexIndex);
 }
 
-void Graph::Previsit(int vertexIndex) {
-    this->vertices[vertexIndex].component = this->cc;
-    this->vertices[vertexIndex].pre = this->clock;
-    this->clock++;
+void Graph::BuildCSR(const std::vector<Edge>& edges) {
+    // Count the out degree of every vertex
+    this->csrOffsets = std::vector<int>(this->numV + 1, 0);
+    for (auto e : edges) {
+        this->csrOffsets[e.from + 1]++;
+    }
+    // Prefix sum gives the start of each vertex's edges
+    for (int i = 0; i < this->numV; i++) {
+        this->csrOffsets[i + 1] += this->csrOffsets[i];
+    }
+
+    // Place each edge at the next free slot of its source
+    this->csrTo = std::vector<int>(edges.size());
+    this->csrWeights = std::vector<int>(edges.size());
+    std::vector<int> next(this->csrOffsets.begin(), this->csrOffsets.end() - 1);
+    for (auto e : edges) {
+        int slot = next[e.from]++;
+        this->csrTo[slot] = e.to;
+        this->csrWeights[slot] = e.weight;
+    }
+}
+
+void Graph::BuildCSRParallel(const std::vector<std::vector<Edge>>& chunks, ThreadPool& pool) {
+    int numChunks = chunks.size();
+    bool undirected = !(this->opts & Directed);
+
+    // Out degree of every vertex counted separately for each chunk
+    std::vector<std::vector<int>> counts(numChunks);
+    pool.Run(numChunks, [&](int c) {
+        PERF_SCOPE(PhaseLoad);
+        counts[c] = std::vector<int>(this->numV, 0);
+        for (auto e : chunks[c]) {
+            counts[c][e.from]++;
+            // Self loops are stored once, like StoreEdge does
+            if (undirected && e.from != e.to)
+                counts[c][e.to]++;
+        }
+    });
+
+    // Prefix sum over vertices gives the start of each vertex's edges
+    this->csrOffsets = std::vector<int>(this->numV + 1, 0);
+    for (int v = 0; v < this->numV; v++) {
+        int degree = 0;
+        for (int c = 0; c < numChunks; c++)
+            degree += counts[c][v];
+        this->csrOffsets[v + 1] = this->csrOffsets[v] + degree;
+    }
+
+    // Turn the counts into the first slot each chunk writes for each vertex,
+    // so edges keep the order they had in the file
+    int numRanges = pool.Size();
+    pool.Run(numRanges, [&](int r) {
+        PERF_SCOPE(PhaseLoad);
+        int first = (long long)this->numV * r / numRanges;
+        int last = (long long)this->numV * (r + 1) / numRanges;
+        for (int v = first; v < last; v++) {
+            int slot = this->csrOffsets[v];
+            for (int c = 0; c < numChunks; c++) {
+                int count = counts[c][v];
+                counts[c][v] = slot;
+                slot += count;
+            }
+        }
+    });
+
+    // Every chunk fills its own slots
+    this->csrTo = std::vector<int>(this->csrOffsets[this->numV]);
+    this->csrWeights = std::vector<int>(this->csrOffsets[this->numV]);
+    pool.Run(numChunks, [&](int c) {
+        PERF_SCOPE(PhaseLoad);
+        std::vector<int>& next = counts[c];
+        for (auto e : chunks[c]) {
+            int slot = next[e.from]++;
+            this->csrTo[slot] = e.to;
+            this->csrWeights[slot] = e.weight;
+            if (undirected && e.from != e.to) {
+                slot = next[e.to]++;
+                this->csrTo[slot] = e.from;
+                this->csrWeights[slot] = e.weight;
+            }
+        }
+    });
 }
 
-void Graph::Postvisit(int vertexIndex) {
-    this->vertices[vertexIndex].post = this->clock;
-    this->clock++;
+Graph::~Graph() {}
+
+DFSWorkspace::DFSWorkspace(int numV)
+    : visited(numV, false), pre(numV, 0), post(numV, 0), component(numV, 0), cc(0), clock(1) {
+    // The stack can't grow past one frame per vertex
+    this->stack.reserve(numV);
 }
 
-void Graph::DFS() {
+bool Graph::NextNeighbor(int vertexIndex, int& cursor, int& to) const {
+    if (this->opts & UseCSR) {
+        int e = this->csrOffsets[vertexIndex] + cursor;
+        if (e >= this->csrOffsets[vertexIndex + 1])
+            return false;
+        to = this->csrTo[e];
+        cursor++;
+        return true;
+    } else if (this->opts & UseList) {
+        const std::vector<ListEdge>& list = this->adjacencyList[vertexIndex];
+        if (cursor >= (int)list.size())
+            return false;
+        to = list[cursor].to;
+        cursor++;
+        return true;
+    } else if (this->UseBits()) {
+        if (cursor >= this->numV)
+            return false;
+        // Next set bit at or after cursor, a word at a time
+        const uint64_t* row = this->BitRow(vertexIndex);
+        int w = cursor / 64;
+        uint64_t bits = row[w] & (~(uint64_t)0 << (cursor % 64));
+        while (bits == 0) {
+            if (++w >= this->bitWords)
+                return false;
+            bits = row[w];
+        }
+        to = w * 64 + __builtin_ctzll(bits);
+        cursor = to + 1;
+        return true;
+    } else {
+        const std::vector<int>& row = this->adjacencies[vertexIndex];
+        // Zero means no edge
+        while (cursor < this->numV && row[cursor] == 0)
+            cursor++;
+        if (cursor >= this->numV)
+            return false;
+        to = cursor;
+        cursor++;
+        return true;
+    }
+}
+
+void Graph::Explore(int vertexIndex, DFSWorkspace& ws) const {
+    // Explicit stack instead of recursion, so path-like graphs can't overflow the call stack.
+    // Neighbors are visited in the same order as a recursive search, giving the same numbering
+    ws.visited[vertexIndex] = true;
+    this->Previsit(vertexIndex, ws);
+    ws.stack.push_back(DFSFrame{ vertexIndex, 0 });
+
+    while (!ws.stack.empty()) {
+        DFSFrame& top = ws.stack.back();
+        int to;
+        if (this->NextNeighbor(top.vertex, top.cursor, to)) {
+            if (!ws.visited[to]) {
+                ws.visited[to] = true;
+                this->Previsit(to, ws);
+                ws.stack.push_back(DFSFrame{ to, 0 });
+            }
+        } else {
+            this->Postvisit(top.vertex, ws);
+            ws.stack.pop_back();
+        }
+    }
+}
+
+void Graph::Previsit(int vertexIndex, DFSWorkspace& ws) const {
+    ws.component[vertexIndex] = ws.cc;
+    ws.pre[vertexIndex] = ws.clock;
+    ws.clock++;
+}
+
+void Graph::Postvisit(int vertexIndex, DFSWorkspace& ws) const {
+    ws.post[vertexIndex] = ws.clock;
+    ws.clock++;
+}
+
+void Graph::DFS(DFSWorkspace& ws) const {
     // Reset values
-    for (auto v : this->vertices)
-        v.visited = false;
-    this->cc = 0;
-    this->clock = 1;
+    ws = DFSWorkspace(this->numV);
 
     for (int i = 0; i < this->numV; i++) {
-        if (!this->vertices[i].visited) {
-            this->cc++;
-            this->Explore(i);
+        if (!ws.visited[i]) {
+            ws.cc++;
+            this->Explore(i, ws);
         }
     }
 }
 
-void Graph::BFS(int startVertexIndex) {
+void Graph::DFS() {
+    DFSWorkspace ws(this->numV);
+    this->DFS(ws);
+    // Keep the numbering on the vertices for printing and Dump
+    for (int i = 0; i < this->numV; i++) {
+        Vertex& v = this->vertices[i];
+        v.visited = ws.visited[i];
+        v.pre = ws.pre[i];
+        v.post = ws.post[i];
+        v.component = ws.component[i];
+    }
+}
+
+ShortestPathResult Graph::BFS(int startVertexIndex) const {
     // Correct for 1 indexing
     startVertexIndex--;
-    Vertex* start = &this->vertices[startVertexIndex];
-
-    // Reset values
-    for (auto other : this->vertices[startVertexIndex].distancePaths) {
-        other.distance = INT32_MAX;
-    }
-    start->distancePaths[startVertexIndex].distance = 0;
+    ShortestPathResult result(startVertexIndex, this->numV);
+    result.distance[startVertexIndex] = 0;
 
     std::queue<int> q;
     q.push(startVertexIndex);
@@ -185,116 +607,160 @@ void Graph::BFS(int startVertexIndex) {
         int currIdx = q.front();
         q.pop();
 
-        for (int i = 0; i < this->numV; i++) {
-            if (start->distancePaths[i].distance == INT32_MAX) {
-                q.push(i);
-                start->distancePaths[i].distance = start->distancePaths[currIdx].distance + 1;
+        int level = result.distance[currIdx];
+        if constexpr (collectStats) {
+            OperationStats& s = Stats();
+            if ((int)s.levelVertices.size() <= level) {
+                s.levelVertices.resize(level + 1, 0);
+                s.levelEdges.resize(level + 1, 0);
             }
+            s.levelVertices[level]++;
         }
+
+        this->ForEachNeighbor(currIdx, [&](int to, int) {
+            if constexpr (collectStats)
+                Stats().levelEdges[level]++;
+            if (result.distance[to] == INT32_MAX) {
+                q.push(to);
+                result.distance[to] = level + 1;
+                result.prev[to] = currIdx;
+            }
+        });
     }
+    return result;
 }
 
-void Graph::Dijkstra(int startVertexIndex) {
+template <typename Heap>
+ShortestPathResult Graph::Dijkstra(int startVertexIndex) const {
     // Correct for 1 indexing
     startVertexIndex--;
-    Vertex* start = &this->vertices[startVertexIndex];
-
-    // Reset values
-    for (auto p : start->distancePaths) {
-        p.distance = INT32_MAX;
-    }
+    ShortestPathResult result(startVertexIndex, this->numV);
 
-    // Binary min heap
     std::vector<Element> els(this->numV);
     for (int i = 0; i < this->numV; i++) {
         els[i] = Element{ i, INT32_MAX };
     }
-    MinHeap heap(els);
+    PERF_BEGIN(PhaseHeapBuild);
+    Heap heap(els);
+    PERF_END(PhaseHeapBuild);
 
-    start->distancePaths[startVertexIndex].distance = 0;
+    result.distance[startVertexIndex] = 0;
     heap.DecreaseKey(startVertexIndex, 0);
 
+    PERF_BEGIN(PhaseSearch);
     while (heap.Size() > 0) {
+        PERF_BEGIN(PhaseDeleteMin);
         int currIdx = heap.DeleteMin();
+        PERF_END(PhaseDeleteMin);
+        int dist = result.distance[currIdx];
+        // Can't get anywhere from an unreachable vertex
+        if (dist == INT32_MAX)
+            continue;
 
-        for (int to = 0; to < this->numV; to++) {
-            // If there is an edge and we can get to it
-            if (this->adjacencies[currIdx][to] != 0 && start->distancePaths[currIdx].distance != INT32_MAX) {
-                int weight = this->adjacencies[currIdx][to];
-                int* currDist = &start->distancePaths[to].distance;
-                int newDist = start->distancePaths[currIdx].distance + weight;
-                if (newDist < *currDist) {
-                    *currDist = newDist;
-                    start->distancePaths[to].prev = &this->vertices[currIdx];
-                    heap.DecreaseKey(to, newDist);
-                }
+        PERF_BEGIN(PhaseRelax);
+        this->ForEachNeighbor(currIdx, [&](int to, int weight) {
+            int newDist = dist + weight;
+            if constexpr (collectStats)
+                Stats().edgesRelaxed++;
+            if (newDist < result.distance[to]) {
+                result.distance[to] = newDist;
+                result.prev[to] = currIdx;
+                heap.DecreaseKey(to, newDist);
+                if constexpr (collectStats)
+                    Stats().edgesImproved++;
             }
-        }
+        });
+        PERF_END(PhaseRelax);
     }
+    PERF_END(PhaseSearch);
+    return result;
 }
 
-int Graph::Prim() {
-    // Reset
-    this->mst = std::vector<MSTEdge>();
-
-    int totalCost = 0;
+template <typename Heap>
+SpanningForest Graph::PrimForest() const {
+    SpanningForest forest(this->numV);
     // Cost tracking
     std::vector<int> costs(this->numV, INT32_MAX);
-    // Prev tracking
-    std::vector<int> prev(this->numV, -1);
+    std::vector<bool> inTree(this->numV, false);
 
-    // Binary min heap
     std::vector<Element> els(this->numV);
     for (int i = 0; i < this->numV; i++) {
         els[i] = Element{ i, INT32_MAX };
     }
-    MinHeap heap(els);
-
-    // Start at first vertex; doesn't matter
-    int start = 0;
-    costs[start] = start;
-    heap.DecreaseKey(start, 0);
+    PERF_BEGIN(PhaseHeapBuild);
+    Heap heap(els);
+    PERF_END(PhaseHeapBuild);
 
+    PERF_BEGIN(PhaseSearch);
     while (heap.Size() > 0) {
+        PERF_BEGIN(PhaseDeleteMin);
         int currIdx = heap.DeleteMin();
-        // Add to MST
-        // if (currIdx != start) {
-        //     this->mst.push_back(
-        //         MSTEdge{ prev[currIdx], currIdx, costs[currIdx] }
-        //     );
-        // }
-        totalCost += costs[currIdx];
-
-        if (this->opts & UseList) {
-            for (auto e : this->adjacencyList[currIdx]) {
-                int weight = e.weight;
-                if (costs[e.to] > weight) {
-                    // The edge is better
-                    costs[e.to] = weight;
-                    prev[e.to] = currIdx;
-                    heap.DecreaseKey(e.to, weight);
-                }
-            }
+        PERF_END(PhaseDeleteMin);
+        inTree[currIdx] = true;
+        if (costs[currIdx] == INT32_MAX) {
+            // Nothing reaches it, so it starts the next tree
+            forest.componentCosts.push_back(0);
         } else {
-            for (int to = 0; to < this->numV; to++) {
-                // If there is an edge
-                if (this->adjacencies[currIdx][to] != 0) {
-                    int weight = this->adjacencies[currIdx][to];
-                    if (costs[to] > weight) {
-                        // The edge is better
-                        costs[to] = weight;
-                        prev[to] = currIdx;
-                        heap.DecreaseKey(to, weight);
-                    }
-                }
-            }
+            forest.weight[currIdx] = costs[currIdx];
+            forest.componentCosts.back() += costs[currIdx];
         }
+        forest.component[currIdx] = forest.componentCosts.size() - 1;
+
+        PERF_BEGIN(PhaseRelax);
+        this->ForEachNeighbor(currIdx, [&](int to, int weight) {
+            if constexpr (collectStats)
+                Stats().edgesRelaxed++;
+            if (!inTree[to] && costs[to] > weight) {
+                // The edge is better
+                costs[to] = weight;
+                forest.parent[to] = currIdx;
+                heap.DecreaseKey(to, weight);
+                if constexpr (collectStats)
+                    Stats().edgesImproved++;
+            }
+        });
+        PERF_END(PhaseRelax);
+    }
+    PERF_END(PhaseSearch);
+
+    for (long long cost : forest.componentCosts)
+        forest.totalCost += cost;
+    return forest;
+}
+
+template <typename Heap>
+long long Graph::Prim() {
+    // Dense matrices are cheaper to scan than to keep in a heap
+    SpanningForest forest = this->IsDense() ? this->DensePrimForest() : this->PrimForest<Heap>();
+
+    // Record the tree edges
+    this->mst = std::vector<MSTEdge>();
+    this->mst.reserve(this->numV);
+    for (int v = 0; v < this->numV; v++) {
+        if (forest.parent[v] != -1)
+            this->mst.push_back(MSTEdge{ forest.parent[v], v, forest.weight[v] });
     }
 
-    this->mstCost = totalCost;
-    return totalCost;
+    this->mstCost = forest.totalCost;
+    this->IndexMST();
+    return this->mstCost;
 }
 
+// The heap implementations the algorithms are built with
+template ShortestPathResult Graph::Dijkstra<MinHeap>(int startVertexIndex) const;
+template ShortestPathResult Graph::Dijkstra<DaryHeap<4>>(int startVertexIndex) const;
+template ShortestPathResult Graph::Dijkstra<DaryHeap<8>>(int startVertexIndex) const;
+template ShortestPathResult Graph::Dijkstra<PairingHeap>(int startVertexIndex) const;
+template ShortestPathResult Graph::Dijkstra<RadixHeap>(int startVertexIndex) const;
+template SpanningForest Graph::PrimForest<MinHeap>() const;
+template SpanningForest Graph::PrimForest<DaryHeap<4>>() const;
+template SpanningForest Graph::PrimForest<DaryHeap<8>>() const;
+template SpanningForest Graph::PrimForest<PairingHeap>() const;
+template long long Graph::Prim<MinHeap>();
+template long long Graph::Prim<DaryHeap<4>>();
+template long long Graph::Prim<DaryHeap<8>>();
+template long long Graph::Prim<PairingHeap>();
+
 void Graph::Dump(std::string fileName) {
     std::ofstream f(fileName);
 
@@ -309,6 +775,40 @@ void Graph::Dump(std::string fileName) {
     f.close();
 }
 
+void Graph::DumpForest(const SpanningForest& forest, std::string fileName) const {
+    bool binary = fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".bin") == 0;
+    std::ofstream f(fileName, binary ? std::ios::binary : std::ios::out);
+    if (!f.good()) {
+        std::cerr << "Error writing file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (binary) {
+        // numV, then the parent, weight and component arrays as int32
+        int32_t n = this->numV;
+        f.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        f.write(reinterpret_cast<const char*>(forest.parent.data()), sizeof(int32_t) * n);
+        f.write(reinterpret_cast<const char*>(forest.weight.data()), sizeof(int32_t) * n);
+        f.write(reinterpret_cast<const char*>(forest.component.data()), sizeof(int32_t) * n);
+    } else {
+        // Vertex, parent, weight, component; roots have no parent
+        for (int i = 0; i < this->numV; i++) {
+            std::ostringstream ss;
+            const Vertex* v = &this->vertices[i];
+            ss << (v->label == "" ? std::to_string(i + 1) : v->label) << ", ";
+            int p = forest.parent[i];
+            if (p == -1)
+                ss << ", ";
+            else
+                ss << (this->vertices[p].label == "" ? std::to_string(p + 1) : this->vertices[p].label) << ", ";
+            ss << forest.weight[i] << ", " << forest.component[i] + 1 << "\n";
+            f << ss.str();
+        }
+    }
+
+    f.close();
+}
+
 std::ostream& operator<<(std::ostream& out, const Graph& g) {
     out << g.GetVertices();
     if (g.mstCost != 0) {
@@ -327,85 +827,54 @@ std::string Graph::GetVertices() const {
         for (int i = 0; i < this->numV; i++) {
             const Vertex* v = &this->vertices[i];
             ss << "Vertex " << v->label << ": {visited: " << v->visited << ", component: " << v->component << ", pre: " << v->pre << ", post: " << v->post << "}\n";
-            // Show distances if some form of BFS was performed on this vertex
-            if (v->distancePaths[i].distance != INT32_MAX) {
-                ss << this->GetDistances(i);
-            }
         }
     } else {
         for (int i = 0; i < this->numV; i++) {
             const Vertex* v = &this->vertices[i];
             ss << "Vertex " << i + 1 << ": {visited: " << v->visited << ", component: " << v->component << ", pre: " << v->pre << ", post: " << v->post << "}\n";
-            // Show distances if some form of BFS was performed on this vertex
-            if (v->distancePaths[i].distance != INT32_MAX) {
-                ss << this->GetDistances(i);
-            }
         }
     }
     return ss.str();
 }
 
-std::string Graph::GetDistances(int vertexIdx) const {
+std::string Graph::GetDistances(const ShortestPathResult& result) const {
     std::ostringstream ss;
-    const Vertex* v = &this->vertices[vertexIdx];
     if (this->labeled) {
-        ss << "Distances from Vertex " << v->label << " {\n";
-        for (int i = 0; i < this->numV; i++) {
-            ss << "\tTo Vertex " << this->vertices[i].label << " => Distance: ";
-            if (v->distancePaths[i].distance == INT32_MAX)
-                ss << "∞";
-            else
-                ss << v->distancePaths[i].distance;
-            ss << ", Prev: ";
-            if (v->distancePaths[i].prev != NULL)
-                ss << v->distancePaths[i].prev->number + 1;
-            else
-                ss << "NULL";
-            ss << "\n";
-        }
-        ss << "}\n";
+        ss << "Distances from Vertex " << this->vertices[result.source].label << " {\n";
     } else {
-        ss << "Distances from Vertex " << vertexIdx << " {\n";
-        for (int i = 0; i < this->numV; i++) {
+        ss << "Distances from Vertex " << result.source + 1 << " {\n";
+    }
+    for (int i = 0; i < this->numV; i++) {
+        if (this->labeled)
+            ss << "\tTo Vertex " << this->vertices[i].label << " => Distance: ";
+        else
             ss << "\tTo Vertex " << i + 1 << " => Distance: ";
-            if (v->distancePaths[i].distance == INT32_MAX)
-                ss << "∞";
-            else
-                ss << v->distancePaths[i].distance;
-            ss << ", Prev: ";
-            if (v->distancePaths[i].prev != NULL)
-                ss << v->distancePaths[i].prev->number + 1;
-            else
-                ss << "NULL";
-            ss << "\n";
-        }
-        ss << "}\n";
+        if (result.distance[i] == INT32_MAX)
+            ss << "∞";
+        else
+            ss << result.distance[i];
+        ss << ", Prev: ";
+        if (result.prev[i] != -1)
+            ss << result.prev[i] + 1;
+        else
+            ss << "NULL";
+        ss << "\n";
     }
-
+    ss << "}\n";
     return ss.str();
 }
 
 std::string Graph::GetEdges() const {
     std::ostringstream ss;
     ss << "\nEdges:\n";
-    if (this->labeled) {
-        for (int fromIdx = 0; fromIdx < this->numV; fromIdx++) {
-            const Vertex* from = &this->vertices[fromIdx];
-            for (int toIdx = 0; toIdx < this->numV; toIdx++) {
-                const Vertex* to = &this->vertices[toIdx];
-                if (this->adjacencies[fromIdx][toIdx] > 0) {
-                    ss << "from: " << from->label << ", to: " << to->label << ", weight: " << this->adjacencies[fromIdx][toIdx] << "\n";
-                }
-            }
-        }
-    } else {
-        for (int from = 0; from < this->numV; from++) {
-            for (int to = 0; to < this->numV; to++) {
-                if (this->adjacencies[from][to] > 0) {
-                    ss << "from: " << from + 1 << ", to: " << to + 1 << ", weight: " << this->adjacencies[from][to] << "\n";
-                }
+    for (int from = 0; from < this->numV; from++) {
+        this->ForEachNeighbor(from, [&](int to, int weight) {
+            if (this->labeled) {
+                ss << "from: " << this->vertices[from].label << ", to: " << this->vertices[to].label << ", weight: " << weight << "\n";
+            } else {
+                ss << "from: " << from + 1 << ", to: " << to + 1 << ", weight: " << weight << "\n";
             }
-        }
+        });
     }
     return ss.str();
 }
@@ -420,7 +889,7 @@ std::string Graph::GetMST() const {
         }
     } else {
         for (auto e : this->mst) {
-            ss << "from: " << e.from << ", to: " << e.to << ", weight: " << e.weight << "\n";
+            ss << "from: " << e.from + 1 << ", to: " << e.to + 1 << ", weight: " << e.weight << "\n";
         }
     }
     return ss.str();
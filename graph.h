@@ -5,6 +5,11 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "union_find.h"
 
 enum Options {
     Directed = 0x01,
@@ -12,14 +17,55 @@ enum Options {
     PrintEdges = 0x04,
     OnlyPrint = 0x08,
     UseList = 0x10, // List or matrix for edges
+    UseCSR = 0x20, // Compressed sparse row storage for edges
+    FastLoad = 0x40, // Memory map the file instead of reading it line by line
+    ParallelLoad = 0x80, // Parse edges of a memory mapped file on several threads
 };
 
 struct Vertex;
+class ThreadPool;
+class MinHeap;
 
-// Represents the shortest path to a vertex, with the distance and the previous node in the path
-struct DistancePath {
-    int distance = INT32_MAX;
-    Vertex* prev = NULL;
+// Distances from one source to every vertex, independent of the graph it came from
+struct ShortestPathResult {
+    int source; // 0-indexed source vertex
+    std::vector<int32_t> distance; // INT32_MAX if unreachable
+    std::vector<int32_t> prev; // Previous vertex on the path, -1 for the source and unreachable vertices
+
+    ShortestPathResult(int source, int numV)
+        : source(source), distance(numV, INT32_MAX), prev(numV, -1) {}
+};
+
+// Distance and path of one point to point query
+struct PathResult {
+    int distance; // INT32_MAX if the target is unreachable
+    std::vector<int> path; // 1-indexed vertices from source to target, empty if unreachable
+    long long settled; // Vertices taken off the heap(s), to compare the query variants
+};
+
+// In-edges of a directed graph in CSR form: edges into v are [offsets[v], offsets[v + 1])
+struct ReverseEdges {
+    std::vector<int> offsets;
+    std::vector<int> from;
+    std::vector<int> weights;
+};
+
+// Planar position of a vertex, for A* distance estimates
+struct Point {
+    double x;
+    double y;
+};
+
+// Minimum spanning forest as a parent array; one tree per connected component
+struct SpanningForest {
+    std::vector<int32_t> parent; // -1 for the root of each tree
+    std::vector<int32_t> weight; // Weight of the edge to the parent, 0 for roots
+    std::vector<int32_t> component; // Tree number, 0-indexed
+    std::vector<long long> componentCosts; // Total weight of each tree
+    long long totalCost;
+
+    SpanningForest(int numV)
+        : parent(numV, -1), weight(numV, 0), component(numV, 0), totalCost(0) {}
 };
 
 // A minimum spanning tree edge with weight included
@@ -36,7 +82,25 @@ struct Vertex {
     int pre; // The pre number
     int post; // The post number
     int component; // The connected component number
-    std::vector<DistancePath> distancePaths; // The distances to other vertices in the graph
+};
+
+// A vertex on the DFS stack and how far through its neighbors the search is
+struct DFSFrame {
+    int vertex;
+    int cursor;
+};
+
+// Per-search DFS state, so searches don't touch the Graph and can run side by side
+struct DFSWorkspace {
+    std::vector<bool> visited;
+    std::vector<int> pre; // The pre numbers
+    std::vector<int> post; // The post numbers
+    std::vector<int> component; // The connected component numbers
+    int cc; // Connected component number
+    int clock; // Previsit/postvisit counter
+    std::vector<DFSFrame> stack; // Search stack, preallocated to numV frames
+
+    DFSWorkspace(int numV);
 };
 
 struct ListEdge {
@@ -44,57 +108,313 @@ struct ListEdge {
     int weight;
 };
 
+// An edge as read from the input, before it is placed into storage
+struct Edge {
+    int from;
+    int to;
+    int weight;
+};
+
 
 class Graph {
 private:
     std::map<std::string, int> labels;
     bool labeled;
     int numV; // Number of vertices
+    long long numE; // Number of stored edges, undirected edges count twice except self loops
     std::vector<Vertex> vertices; // List of vertices
     std::vector<std::vector<int>> adjacencies; // The adjancency matrix
+    // Matrix storage for unweighted graphs: one bit per edge, row v is words [v * bitWords, (v + 1) * bitWords)
+    std::vector<uint64_t> adjacencyBits;
+    int bitWords; // 64-bit words per bit matrix row
     std::vector<std::vector<ListEdge>> adjacencyList; // The adjancency list
+    // Compressed sparse row storage: edges of vertex v are [csrOffsets[v], csrOffsets[v + 1])
+    std::vector<int> csrOffsets;
+    std::vector<int> csrTo;
+    std::vector<int> csrWeights;
 
 
-    int cc; // Connected component number
-    int clock; // Previsit/postvisit counter
-
-    int mstCost; // Total cost of the MST
+    long long mstCost; // Total cost of the MST
     std::vector<MSTEdge> mst; // All the edges in the MST
+    // Forest adjacency of mst, kept in step with it for updates: neighbor and the mst index of the edge to it
+    std::vector<std::vector<std::pair<int, int>>> mstAdjacency;
+    bool mstCurrent; // mst matches the edges, so updates can repair it instead of dropping it
+
+    // Connectivity kept across edge insertions; a removal marks it stale until the next query
+    UnionFind componentSets;
+    bool componentsCurrent;
+
+    // In-edges of a directed graph for backward searches, built by the first bidirectional query or bottom-up BFS.
+    // Edge updates swap in a fresh cache, so copies of the graph keep the one matching their edges
+    struct ReverseEdgesCache {
+        std::once_flag built;
+        std::shared_ptr<const ReverseEdges> edges;
+    };
+    std::shared_ptr<ReverseEdgesCache> reverseEdges = std::make_shared<ReverseEdgesCache>();
+    std::vector<Point> coordinates; // From LoadCoordinates, empty if none were loaded
 
     // Input type flags
     unsigned char opts;
+    int numThreads; // Threads used for parallel loading, 0 for all cores
+
+    // Parse the file with getline and a stringstream per line
+    void ReadStream(std::string fileName, std::vector<Edge>& edges);
+    // Parse the file straight out of a memory mapping
+    void ReadMapped(std::string fileName, std::vector<Edge>& edges);
+    // Parses from, to and weight of the edge line at p, false if a vertex is out of range
+    bool ParseEdgeLine(const char* p, const char* end, Edge& e) const;
+    // Parses newline aligned chunks of the edge section concurrently, then merges them into storage
+    void ParseEdgesParallel(const char* p, const char* end, std::vector<Edge>& edges);
+    // Load a snapshot written by SaveBinary; the graph always uses CSR storage.
+    // False after printing why if the file is truncated or its header, offsets, edges or labels are corrupt
+    bool ReadBinary(std::string fileName);
+    void InitVertices(int numV);
+    // Labels are 1-indexed like vertex numbers
+    void AddLabel(std::string label, int num);
+    // Allocates the matrix or list for the selected storage
+    void InitStorage();
+    // Places an edge (and its reverse if undirected) in storage; CSR edges go into edges until packed
+    void StoreEdge(int from, int to, int weight, std::vector<Edge>& edges);
+    // Packs the edges into the CSR arrays with a counting sort on the source vertex
+    void BuildCSR(const std::vector<Edge>& edges);
+    // CSR packing of per-chunk edge buffers; keeps file order so the result matches BuildCSR
+    void BuildCSRParallel(const std::vector<std::vector<Edge>>& chunks, ThreadPool& pool);
+    // Calls visit(to, weight) for every edge leaving the vertex, whichever storage is in use
+    template <typename F>
+    void ForEachNeighbor(int vertexIndex, F visit) const;
+    // Resumable neighbor iteration: sets to the neighbor at cursor and advances it, false when done.
+    // Start with cursor = 0
+    bool NextNeighbor(int vertexIndex, int& cursor, int& to) const;
+    // Like ForEachNeighbor but stops at the first edge where visit returns true; returns whether it did
+    template <typename F>
+    bool AnyNeighbor(int vertexIndex, F visit) const;
+
+    // Matrix storage without weights keeps one bit per edge instead of an int
+    bool UseBits() const { return !(this->opts & (UseList | UseCSR | Weighted)); }
+    // Whether a 1-indexed vertex number from the public API exists
+    bool IsVertex(int v) const { return v >= 1 && v <= this->numV; }
+    const uint64_t* BitRow(int vertexIndex) const { return this->adjacencyBits.data() + (size_t)vertexIndex * this->bitWords; }
 
-    void Previsit(int vertexIndex);
-    void Postvisit(int vertexIndex);
+    long long CountEdges() const;
+    // Edges leaving the vertex; constant time for list and CSR storage, a row scan for matrices
+    int OutDegree(int vertexIndex) const;
+
+    // Single directed entry edits for every storage, 0-indexed. Bit matrices ignore the weight.
+    // List and CSR storage keep parallel edges from the input: EdgeWeight reports the lightest copy,
+    // SetEdge collapses them into one, and both edits return the change in stored edges
+    bool EdgeWeight(int from, int to, int& weight) const;
+    int SetEdge(int from, int to, int weight);
+    // Erases every copy after the first keep of them
+    int EraseEdge(int from, int to, int keep = 0);
+    // Builds mstAdjacency for a freshly recorded mst and marks it current
+    void IndexMST();
+    // Appends a tree edge, or removes one by moving the last edge into its index
+    void AddToMST(const MSTEdge& e);
+    void RemoveFromMST(int index);
+    // Depth first search over the recorded MST from the vertex; parentEdge is the mst index of the
+    // edge used to reach each vertex, -1 for the start and -2 for vertices in other trees
+    void SearchMST(int from, std::vector<int>& parentEdge) const;
+    // Cycle property: the edge replaces the heaviest edge on the tree path between its ends if lighter
+    void InsertIntoMST(int from, int to, int weight);
+    // Drops a tree edge and reconnects its two sides with the cheapest edge across them, if any
+    void ReplaceInMST(int index);
+    // Forgets the recorded MST; directed graphs have no repair rule, so the next Prim/Kruskal/Boruvka recomputes
+    void DropMST();
+    // Index of the tree edge between the vertices, -1 if it isn't in the MST
+    int FindInMST(int from, int to) const;
+
+    // Builds reverseEdges if needed; concurrent queries on the same graph wait for the first
+    std::shared_ptr<const ReverseEdges> ReverseEdgesOf() const;
+
+    // Matrix storage with at least a quarter of all possible edges present
+    bool IsDense() const;
+
+    // Every edge a spanning forest can use, undirected edges listed once
+    std::vector<Edge> SpanningEdges() const;
+
+    void Previsit(int vertexIndex, DFSWorkspace& ws) const;
+    void Postvisit(int vertexIndex, DFSWorkspace& ws) const;
 
     std::string GetVertices() const;
-    std::string GetDistances(int vertexIdx) const;
     std::string GetEdges() const;
     std::string GetMST() const;
 
 public:
-    // Reads graph in from a file
-    Graph(std::string fileName, unsigned char readFlags);
+    // Reads graph in from a text file or a binary snapshot
+    Graph(std::string fileName, unsigned char readFlags, int numThreads = 0);
+    // Builds the graph from 0-indexed edges already in memory, e.g. from the generator
+    Graph(int numV, const std::vector<Edge>& edges, unsigned char options, int numThreads = 0);
     ~Graph();
 
     // Visits all vertices in the connected component containing vertex v
-    void Explore(int vertexIndex);
-    // Visits all vertices in the graph
+    void Explore(int vertexIndex, DFSWorkspace& ws) const;
+    // Visits all vertices in the graph, numbering them in the workspace
+    void DFS(DFSWorkspace& ws) const;
+    // Visits all vertices in the graph and stores the numbering on the vertices
     void DFS();
-    // Sets distances to each vertex from the starting vertex
-    void BFS(int startVertexIndex);
+    // Parallel connected components (afforest: union-find with neighbor sampling), 0 threads uses all cores.
+    // Fills only component and cc in the workspace, numbered like DFS on undirected graphs.
+    // Directed edges are followed both ways, giving weakly connected components
+    void ConnectedComponents(DFSWorkspace& ws, int numThreads = 0) const;
+    // Stores the component numbers on the vertices
+    void ConnectedComponents(int numThreads = 0);
+    // Returns distances to each vertex from the starting vertex
+    ShortestPathResult BFS(int startVertexIndex) const;
+
+    // Heap is any indexed priority queue with MinHeap's interface:
+    // MinHeap, DaryHeap<D>, PairingHeap, or RadixHeap (Dijkstra only; keys must be monotone)
+    template <typename Heap = MinHeap>
+    ShortestPathResult Dijkstra(int startVertexIndex) const;
 
-    void Dijkstra(int startVertexIndex);
+    // Point to point queries, vertices 1-indexed; all three return the same distance.
+    // Dijkstra that stops once the target leaves the heap and only builds heap entries for reached vertices.
+    // Out of range vertices give no path
+    template <typename Heap = MinHeap>
+    PathResult ShortestPath(int source, int target) const;
+    // Searches forward from the source and backward from the target until the frontiers meet.
+    // Directed graphs search the reverse edges, built on the first call and kept until an edge update
+    template <typename Heap = MinHeap>
+    PathResult BidirectionalDijkstra(int source, int target) const;
+    // Dijkstra ordered by distance plus heuristic(v), a lower bound on the distance from v (1-indexed) to the target.
+    // Any admissible heuristic gives the shortest distance; consistent ones never take a vertex off twice.
+    // No RadixHeap, since an inconsistent heuristic gives keys that aren't monotone
+    template <typename Heap = MinHeap>
+    PathResult AStar(int source, int target, const std::function<int(int)>& heuristic) const;
+    // Reads "vertex x y" lines (1-indexed, # comments) so EuclideanHeuristic can estimate distances
+    void LoadCoordinates(std::string fileName);
+    // Straight line distance to the target, rounded down; admissible when no edge is shorter than the
+    // distance between its ends. Always 0 (plain Dijkstra order) without coordinates
+    std::function<int(int)> EuclideanHeuristic(int target) const;
 
-    // Returns full cost of MST
-    int Prim();
+    // Parallel frontier BFS that switches between top-down and bottom-up steps per level, run on the pool.
+    // Returns the same distances as BFS. Directed graphs share the reverse edges of BidirectionalDijkstra
+    ShortestPathResult DirectionOptimizingBFS(int startVertexIndex, ThreadPool& pool) const;
+
+    // Parallel single source shortest paths over buckets of width delta; weights must be non-negative.
+    // Returns the same distances as Dijkstra. delta <= 0 picks one from the weights, and a delta needing more
+    // than 2^16 buckets for the largest weight is raised. 0 threads uses all cores. Paths past INT32_MAX stay unreachable
+    ShortestPathResult DeltaStepping(int startVertexIndex, int delta = 0, int numThreads = 0) const;
+
+    // Runs BFS/Dijkstra from every source on the pool; results are in the same order as sources.
+    // Only const queries run, so one Graph can serve any number of batches at once. Batches sharing a pool
+    // take turns on it; give each its own pool to run them side by side
+    std::vector<ShortestPathResult> BatchBFS(const std::vector<int>& sources, ThreadPool& pool) const;
+    template <typename Heap = MinHeap>
+    std::vector<ShortestPathResult> BatchDijkstra(const std::vector<int>& sources, ThreadPool& pool) const;
+
+    // Returns full cost of MST (of every tree if the graph is disconnected) and records its edges
+    template <typename Heap = MinHeap>
+    long long Prim();
+    // Prim restarted at each component; fills preallocated parent/weight arrays instead of an edge list
+    template <typename Heap = MinHeap>
+    SpanningForest PrimForest() const;
+    // Returns the cost of the minimum spanning forest, recording its edges.
+    // Edges are radix sorted by weight on a pool of threads, 0 uses all cores
+    long long Kruskal(int numThreads = 0);
+    // Returns the cost of the minimum spanning forest, recording its edges.
+    // Each Boruvka round finds every component's cheapest edge in parallel; 0 threads uses all cores
+    long long Boruvka(int numThreads = 0);
+
+    // Edge updates, vertices 1-indexed; undirected edges change in both directions.
+    // Adding an edge that exists sets its weight. CSR storage shifts its arrays, O(V + E) per update.
+    // Weighted matrix storage treats weight 0 as no edge, so it rejects it; unweighted graphs keep weight 1.
+    // An MST recorded by Prim/Kruskal/Boruvka on an undirected graph is repaired in place, on a directed one dropped:
+    // insertions and decreases in O(V) on top of the storage edit, removals and increases of tree edges in O(V + E).
+    // All three return false, changing nothing, for a vertex outside 1..V
+    bool AddEdge(int from, int to, int weight = 1);
+    // False if there was no such edge. Parallel copies of an edge are removed together, and
+    // AddEdge/UpdateWeight on one collapse them into a single edge with the new weight
+    bool RemoveEdge(int from, int to);
+    bool UpdateWeight(int from, int to, int weight);
+
+    // Whether the vertices (1-indexed) are connected, following directed edges both ways; false if either
+    // doesn't exist. Insertions update a union-find; the first query after a removal rebuilds it
+    bool Connected(int a, int b);
+    int NumComponents();
+
+    // Writes the graph as a binary snapshot that loads without parsing
+    void SaveBinary(std::string fileName) const;
+    // Reads a snapshot written by SaveBinary; the constructor also accepts snapshots directly
+    static Graph LoadBinary(std::string fileName, unsigned char options);
+    // Whether the file starts with the snapshot magic
+    static bool IsSnapshot(std::string fileName);
+
+    int NumVertices() const { return this->numV; }
+
+    // Distance and previous vertex for every vertex in a BFS/Dijkstra result
+    std::string GetDistances(const ShortestPathResult& result) const;
 
     // Writes vertex data out to file in csv format
     void Dump(std::string fileName);
 
+    // O(V^2) Prim for weighted matrix storage: scans a key array for the minimum instead of using a heap.
+    // Uses AVX2 for the minimum search and row relaxation when the CPU has it. Prim() picks it for dense graphs.
+    // Other storage falls back to PrimForest
+    SpanningForest DensePrimForest() const;
+
+    // Writes the forest as csv (vertex, parent, weight, component), or as raw int32 arrays if fileName ends in .bin
+    void DumpForest(const SpanningForest& forest, std::string fileName) const;
+
     // Prints vertices and edges
     friend std::ostream& operator<<(std::ostream& out, const Graph& g);
 };
 
+template <typename F>
+void Graph::ForEachNeighbor(int vertexIndex, F visit) const {
+    if (this->opts & UseCSR) {
+        for (int e = this->csrOffsets[vertexIndex]; e < this->csrOffsets[vertexIndex + 1]; e++) {
+            visit(this->csrTo[e], this->csrWeights[e]);
+        }
+    } else if (this->opts & UseList) {
+        for (auto e : this->adjacencyList[vertexIndex]) {
+            visit(e.to, e.weight);
+        }
+    } else if (this->UseBits()) {
+        const uint64_t* row = this->BitRow(vertexIndex);
+        for (int w = 0; w < this->bitWords; w++) {
+            for (uint64_t bits = row[w]; bits != 0; bits &= bits - 1)
+                visit(w * 64 + __builtin_ctzll(bits), 1);
+        }
+    } else {
+        const std::vector<int>& row = this->adjacencies[vertexIndex];
+        for (int to = 0; to < this->numV; to++) {
+            // Zero means no edge
+            if (row[to] != 0) {
+                visit(to, row[to]);
+            }
+        }
+    }
+}
+
+template <typename F>
+bool Graph::AnyNeighbor(int vertexIndex, F visit) const {
+    if (this->opts & UseCSR) {
+        for (int e = this->csrOffsets[vertexIndex]; e < this->csrOffsets[vertexIndex + 1]; e++) {
+            if (visit(this->csrTo[e], this->csrWeights[e]))
+                return true;
+        }
+    } else if (this->opts & UseList) {
+        for (auto e : this->adjacencyList[vertexIndex]) {
+            if (visit(e.to, e.weight))
+                return true;
+        }
+    } else if (this->UseBits()) {
+        const uint64_t* row = this->BitRow(vertexIndex);
+        for (int w = 0; w < this->bitWords; w++) {
+            for (uint64_t bits = row[w]; bits != 0; bits &= bits - 1) {
+                if (visit(w * 64 + __builtin_ctzll(bits), 1))
+                    return true;
+            }
+        }
+    } else {
+        const std::vector<int>& row = this->adjacencies[vertexIndex];
+        for (int to = 0; to < this->numV; to++) {
+            // Zero means no edge
+            if (row[to] != 0 && visit(to, row[to]))
+                return true;
+        }
+    }
+    return false;
+}
 
 #endif // GRAPH_H
\ No newline at end of file
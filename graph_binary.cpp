@@ -0,0 +1,180 @@
+#include <cstring>
+#include <cstdint>
+#include "graph.h"
+#include "mapped_file.h"
+
+// Binary snapshot layout, all values in native byte order:
+//   SnapshotHeader
+//   int32 offsets[numV + 1]
+//   int32 to[numEdges]
+//   int32 weights[numEdges] (only if weighted)
+//   labels as numV NUL-terminated strings (only if labeled)
+// Undirected edges are stored in both directions, exactly like CSR storage.
+
+static const char snapshotMagic[4] = { 'G', 'R', 'P', 'H' };
+static const uint32_t snapshotVersion = 1;
+
+enum SnapshotFlags {
+    SnapshotDirected = 0x01,
+    SnapshotWeighted = 0x02,
+    SnapshotLabeled = 0x04,
+};
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    int32_t numV;
+    int64_t numEdges;
+    int64_t labelBytes;
+};
+
+bool Graph::IsSnapshot(std::string fileName) {
+    std::ifstream f(fileName, std::ios::binary);
+    char magic[4];
+    if (!f.read(magic, sizeof(magic)))
+        return false;
+    return memcmp(magic, snapshotMagic, sizeof(magic)) == 0;
+}
+
+Graph Graph::LoadBinary(std::string fileName, unsigned char options) {
+    if (!IsSnapshot(fileName)) {
+        std::cerr << "Not a graph snapshot: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return Graph(fileName, options);
+}
+
+bool Graph::ReadBinary(std::string fileName) {
+    MappedFile file(fileName);
+    const char* p = file.Begin();
+
+    SnapshotHeader header;
+    if (file.Size() < sizeof(header)) {
+        std::cerr << "Truncated graph snapshot: " << fileName << std::endl;
+        return false;
+    }
+    memcpy(&header, p, sizeof(header));
+    p += sizeof(header);
+    if (header.version != snapshotVersion) {
+        std::cerr << "Unsupported graph snapshot version " << header.version << ": " << fileName << std::endl;
+        return false;
+    }
+    // Offsets are int32, so no more edges than that; sizes are checked before they are multiplied
+    if (header.numV < 0 || header.numEdges < 0 || header.numEdges > INT32_MAX || header.labelBytes < 0 ||
+        (uint64_t)header.labelBytes > file.Size()) {
+        std::cerr << "Corrupt graph snapshot header: " << fileName << std::endl;
+        return false;
+    }
+    bool weighted = header.flags & SnapshotWeighted;
+    uint64_t expected = sizeof(header) + sizeof(int32_t) * ((uint64_t)header.numV + 1 + (uint64_t)header.numEdges * (weighted ? 2 : 1)) + header.labelBytes;
+    if (file.Size() < expected) {
+        std::cerr << "Truncated graph snapshot: " << fileName << std::endl;
+        return false;
+    }
+
+    // Check the arrays before anything indexes with them
+    const int32_t* offsets = reinterpret_cast<const int32_t*>(p);
+    const int32_t* to = offsets + header.numV + 1;
+    bool valid = offsets[0] == 0 && offsets[header.numV] == header.numEdges;
+    for (int v = 0; valid && v < header.numV; v++) {
+        valid = offsets[v] <= offsets[v + 1];
+    }
+    for (int64_t e = 0; valid && e < header.numEdges; e++) {
+        valid = to[e] >= 0 && to[e] < header.numV;
+    }
+    if (!valid) {
+        std::cerr << "Corrupt graph snapshot edges: " << fileName << std::endl;
+        return false;
+    }
+
+    // Snapshots are always CSR; direction and weights come from the file
+    this->opts &= ~(Directed | Weighted | UseList);
+    this->opts |= UseCSR;
+    if (header.flags & SnapshotDirected)
+        this->opts |= Directed;
+    if (weighted)
+        this->opts |= Weighted;
+
+    this->InitVertices(header.numV);
+
+    this->csrOffsets = std::vector<int>(offsets, offsets + header.numV + 1);
+    p += sizeof(int32_t) * (header.numV + 1);
+
+    this->csrTo = std::vector<int>(to, to + header.numEdges);
+    p += sizeof(int32_t) * header.numEdges;
+
+    if (weighted) {
+        const int32_t* weights = reinterpret_cast<const int32_t*>(p);
+        this->csrWeights = std::vector<int>(weights, weights + header.numEdges);
+        p += sizeof(int32_t) * header.numEdges;
+    } else {
+        this->csrWeights = std::vector<int>(header.numEdges, 1);
+    }
+
+    if (header.flags & SnapshotLabeled) {
+        this->labeled = true;
+        const char* labelsEnd = p + header.labelBytes;
+        for (int i = 0; i < this->numV; i++) {
+            // Every label has to end inside the table
+            const char* nul = static_cast<const char*>(memchr(p, '\0', labelsEnd - p));
+            if (nul == NULL) {
+                std::cerr << "Corrupt graph snapshot labels: " << fileName << std::endl;
+                return false;
+            }
+            this->AddLabel(std::string(p, nul), i + 1);
+            p = nul + 1;
+        }
+    }
+    return true;
+}
+
+void Graph::SaveBinary(std::string fileName) const {
+    std::ofstream f(fileName, std::ios::binary);
+    if (!f.good()) {
+        std::cerr << "Error writing file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Flatten whatever storage is in use into CSR order
+    std::vector<int32_t> offsets(this->numV + 1, 0);
+    std::vector<int32_t> to;
+    std::vector<int32_t> weights;
+    for (int v = 0; v < this->numV; v++) {
+        this->ForEachNeighbor(v, [&](int u, int weight) {
+            to.push_back(u);
+            weights.push_back(weight);
+        });
+        offsets[v + 1] = to.size();
+    }
+
+    std::string labelTable;
+    if (this->labeled) {
+        for (auto& v : this->vertices) {
+            labelTable += v.label;
+            labelTable.push_back('\0');
+        }
+    }
+
+    SnapshotHeader header;
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = snapshotVersion;
+    header.flags = 0;
+    if (this->opts & Directed)
+        header.flags |= SnapshotDirected;
+    if (this->opts & Weighted)
+        header.flags |= SnapshotWeighted;
+    if (this->labeled)
+        header.flags |= SnapshotLabeled;
+    header.numV = this->numV;
+    header.numEdges = to.size();
+    header.labelBytes = labelTable.size();
+
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    f.write(reinterpret_cast<const char*>(offsets.data()), sizeof(int32_t) * offsets.size());
+    f.write(reinterpret_cast<const char*>(to.data()), sizeof(int32_t) * to.size());
+    if (this->opts & Weighted)
+        f.write(reinterpret_cast<const char*>(weights.data()), sizeof(int32_t) * weights.size());
+    f.write(labelTable.data(), labelTable.size());
+    f.close();
+}
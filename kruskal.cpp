@@ -0,0 +1,94 @@
+#include <cstdint>
+#include "graph.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+// Order-preserving unsigned key for a signed weight
+static uint32_t RadixKey(int weight) {
+    return (uint32_t)weight ^ 0x80000000u;
+}
+
+// Stable LSD radix sort of edges by weight, one byte per pass. Each task
+// histograms and scatters its own contiguous slice, so the output is the
+// same for any number of threads
+static void RadixSortByWeight(std::vector<Edge>& edges, ThreadPool& pool) {
+    int numTasks = pool.Size();
+    size_t n = edges.size();
+    std::vector<Edge> buffer(n);
+    std::vector<std::vector<size_t>> counts(numTasks, std::vector<size_t>(256));
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        pool.Run(numTasks, [&](int t) {
+            std::vector<size_t>& count = counts[t];
+            std::fill(count.begin(), count.end(), 0);
+            for (size_t i = n * t / numTasks; i < n * (t + 1) / numTasks; i++)
+                count[RadixKey(edges[i].weight) >> shift & 0xFF]++;
+        });
+
+        // Skip the pass when every edge has the same byte here
+        bool trivial = false;
+        for (int b = 0; b < 256 && !trivial; b++) {
+            size_t total = 0;
+            for (int t = 0; t < numTasks; t++)
+                total += counts[t][b];
+            trivial = total == n;
+        }
+        if (trivial)
+            continue;
+
+        // Turn counts into the first output slot of each (byte, task)
+        size_t slot = 0;
+        for (int b = 0; b < 256; b++) {
+            for (int t = 0; t < numTasks; t++) {
+                size_t count = counts[t][b];
+                counts[t][b] = slot;
+                slot += count;
+            }
+        }
+
+        pool.Run(numTasks, [&](int t) {
+            std::vector<size_t>& next = counts[t];
+            for (size_t i = n * t / numTasks; i < n * (t + 1) / numTasks; i++)
+                buffer[next[RadixKey(edges[i].weight) >> shift & 0xFF]++] = edges[i];
+        });
+        edges.swap(buffer);
+    }
+}
+
+std::vector<Edge> Graph::SpanningEdges() const {
+    // Each undirected edge once; self loops never join anything
+    std::vector<Edge> edges;
+    for (int from = 0; from < this->numV; from++) {
+        this->ForEachNeighbor(from, [&](int to, int weight) {
+            if (from < to || (this->opts & Directed && from != to))
+                edges.push_back(Edge{ from, to, weight });
+        });
+    }
+    return edges;
+}
+
+long long Graph::Kruskal(int numThreads) {
+    // Reset
+    this->mst = std::vector<MSTEdge>();
+
+    std::vector<Edge> edges = this->SpanningEdges();
+
+    ThreadPool pool(numThreads);
+    RadixSortByWeight(edges, pool);
+
+    // Take the cheapest edges that join two different trees
+    UnionFind sets(this->numV);
+    long long totalCost = 0;
+    for (auto e : edges) {
+        if (sets.Union(e.from, e.to)) {
+            this->mst.push_back(MSTEdge{ e.from, e.to, e.weight });
+            totalCost += e.weight;
+            if (sets.NumSets() == 1)
+                break;
+        }
+    }
+
+    this->mstCost = totalCost;
+    this->IndexMST();
+    return totalCost;
+}
@@ -2,32 +2,28 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <cstdlib>
 #include <fstream>
-#include <time.h>
-#include <cmath>
 #include <algorithm>
 #include "graph.h"
+#include "edge_stream.h"
+#include "generator.h"
+#include "perf_counters.h"
+#include "stats.h"
 #include "min_heap.h"
 
-bool compareFileSize(std::string f1, std::string f2) {
-    int endIdx = f1.rfind('-');
-    int beginIdx = f1.rfind('-', endIdx - 1);
-    int size1 = atoi(f1.substr(beginIdx + 1, endIdx - beginIdx - 1).c_str());
-
-    endIdx = f2.rfind('-');
-    beginIdx = f2.rfind('-', endIdx - 1);
-    int size2 = atoi(f2.substr(beginIdx + 1, endIdx - beginIdx - 1).c_str());
-
-    return size1 < size2;
-}
-
 void printOptions(unsigned char options) {
     std::ostringstream ss;
     ss << "MODE: ";
     ss << (options & Directed ? "DIRECTED " : "UNDIRECTED ");
     ss << (options & Weighted ? "WEIGHTED " : "UNWEIGHTED ");
     ss << (options & PrintEdges ? "PRINT_EDGES " : "");
-    ss << (options & UseList ? "ADJACENCY LIST " : "ADJACENCY MATRIX ");
+    ss << (options & FastLoad ? "MAPPED " : "");
+    ss << (options & ParallelLoad ? "PARALLEL_LOAD " : "");
+    if (options & UseCSR)
+        ss << "CSR ";
+    else
+        ss << (options & UseList ? "ADJACENCY LIST " : "ADJACENCY MATRIX ");
     std::cout << ss.str() << std::endl;
 }
 
@@ -58,7 +54,7 @@ void printGraph(std::string fileName, unsigned char options) {
     // g.DFS();
     // g.BFS(1);
     // g.Dijkstra(1);
-    int cost = g.Prim();
+    long long cost = g.Prim();
     std::cout << cost << std::endl;
 
     // Temp for 5b
@@ -70,70 +66,66 @@ void printGraph(std::string fileName, unsigned char options) {
     //std::cout << g << std::endl;
 }
 
-// makeheap(), deletemin(), insert() and decreasekey()
-void timeBinaryHeap() {
-    srand(time(NULL));
-    std::ofstream f("min-heap.csv");
-
-    for (int i = 4; i <= 28; i++) {
-        double avgMakeHeap, avgDeleteMin, avgInsert, avgDecreaseKey = 0;
-        int size = 2 << i - 1;
-        int reps = 10;
-        int innerReps = 100000;
-        if (i > 22) {
-            reps = 4;
-        }
-        if (i > 24) {
-            reps = 2;
-        }
-        for (int j = 0; j < reps; j++) {
-            // Create vector
-            std::vector<Element> S(size);
-            for (int el = 0; el < size; el++) {
-                S[el] = Element{ el, (rand() % 100) - 100 };
-            }
-
-            double start, elapsed;
-
-            // n log n
-            start = clock();
-            MinHeap h(S);
-            elapsed = (clock() - start) / CLOCKS_PER_SEC;
-            avgMakeHeap += elapsed;
+// Parses a text graph once and writes it next to the original as <file>.bin
+void convertToBinary(std::string fileName, unsigned char options) {
+    Graph g = Graph(fileName, options);
+    std::string outFile = fileName + ".bin";
+    g.SaveBinary(outFile);
+    std::cout << fileName << " -> " << outFile << std::endl;
+}
 
-            for (int k = 0; k < innerReps; k++) {
-                // Sift
-                start = clock();
-                h.DeleteMin();
-                elapsed = (clock() - start) / CLOCKS_PER_SEC;
-                avgDeleteMin += elapsed;
+// Writes the minimum spanning forest next to the original as <file>.forest.csv
+void writeForest(std::string fileName, unsigned char options) {
+    Graph g = Graph(fileName, options);
+    SpanningForest forest = g.PrimForest();
+    std::string outFile = fileName + ".forest.csv";
+    g.DumpForest(forest, outFile);
+    std::cout << fileName << " -> " << outFile << ": " << forest.componentCosts.size() << " trees, cost " << forest.totalCost << std::endl;
+}
 
-                // Bubble
-                start = clock();
-                h.Insert(Element{ size + 1, k });
-                elapsed = (clock() - start) / CLOCKS_PER_SEC;
-                avgInsert += elapsed;
+// Components and MST cost of a file without ever storing the graph
+void streamGraph(std::string fileName, unsigned char options, size_t memoryBytes) {
+    EdgeStream stream(fileName, options, memoryBytes);
+    std::vector<int> component = StreamComponents(stream);
+    int numComponents = component.empty() ? 0 : *std::max_element(component.begin(), component.end());
+    std::vector<MSTEdge> mst;
+    long long cost = StreamKruskal(stream, mst);
+    std::cout << fileName << ": " << numComponents << " components, " << mst.size() << " forest edges, cost " << cost << std::endl;
+}
 
-                // Bubble
-                start = clock();
-                h.DecreaseKey(size / 2, S[size / 2].key - 10);
-                elapsed = (clock() - start) / CLOCKS_PER_SEC;
-                avgDecreaseKey += elapsed;
-            }
-        }
+static void printPath(const char* name, const PathResult& result) {
+    std::cout << name << ": ";
+    if (result.distance == INT32_MAX) {
+        std::cout << "unreachable";
+    } else {
+        std::cout << result.distance << " via";
+        for (int v : result.path)
+            std::cout << " " << v;
+    }
+    std::cout << " (" << result.settled << " settled)" << std::endl;
+}
 
-        std::ostringstream ss;
-        // Calculate average and write to file
-        ss << i << ", " << size << ", ";
-        ss << avgMakeHeap / reps << ", ";
-        ss << avgDeleteMin / (reps * innerReps) << ", ";
-        ss << avgInsert / (reps * innerReps) << ", ";
-        ss << avgDecreaseKey / (reps * innerReps);
+// Distance and path between two vertices with each point to point query
+void queryPath(std::string fileName, unsigned char options, std::string query, std::string coordinateFile) {
+    int source, target;
+    char colon;
+    std::istringstream ss(query);
+    if (!(ss >> source >> colon >> target) || colon != ':') {
+        std::cerr << "Bad query, expected source:target: " << query << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
-        std::cout << ss.str() << std::endl;
-        f << ss.str() << "\n";
+    Graph g = Graph(fileName, options);
+    if (source < 1 || source > g.NumVertices() || target < 1 || target > g.NumVertices()) {
+        std::cerr << "Bad query, vertices must be between 1 and " << g.NumVertices() << ": " << query << std::endl;
+        exit(EXIT_FAILURE);
     }
-    f.close();
+    if (!coordinateFile.empty())
+        g.LoadCoordinates(coordinateFile);
+    std::cout << fileName << " " << source << " -> " << target << std::endl;
+    printPath("Dijkstra", g.ShortestPath(source, target));
+    printPath("Bidirectional", g.BidirectionalDijkstra(source, target));
+    printPath("A*", g.AStar(source, target, g.EuclideanHeuristic(target)));
 }
 
 void testBinaryHeap() {
@@ -162,108 +154,17 @@ void testBinaryHeap() {
 
 }
 
-void timePrimsIndividual(std::vector<std::string> files, unsigned char opts) {
-    std::ofstream f("out/prim-times-individual.csv");
-    printOptions(opts);
-
-
-    for (auto fileName : files) {
-        double avgTime = 0;
-        double reps = 0;
-        int cost;
-        // Get size of graph from filename
-        int endIdx = fileName.rfind('-');
-        int beginIdx = fileName.rfind('-', endIdx - 1);
-        int size = atoi(fileName.substr(beginIdx + 1, endIdx - beginIdx - 1).c_str());
-
-
-        Graph g = Graph(fileName, opts);
-
-        double innerReps = 1;
-        if (size <= 100000) {
-            innerReps = 4;
-        }
-        if (size <= 10000) {
-            innerReps = 10;
-        }
-        if (size <= 1000) {
-            innerReps = 100;
-        }
-        for (size_t i = 0; i < innerReps; i++) {
-            // Time it
-            reps++;
-            double start, elapsed;
-            start = clock();
-            cost = g.Prim();
-            elapsed = (clock() - start) / CLOCKS_PER_SEC;
-            avgTime += elapsed;
-        }
-
-        std::cout << fileName << ", " << avgTime / reps << ", " << cost << std::endl;
-        f << fileName << ", " << avgTime / reps << ", " << cost << "\n";
-
-    }
-
-    f.close();
-}
-
-void timePrimsAverage(std::vector<std::string> files, unsigned char opts) {
-    std::ofstream f("out/prim-times-average.csv");
-    printOptions(opts);
-
-    int lastSize = 0;
-    double avgTime = 0;
-    double reps = 0;
-
-    for (auto fileName : files) {
-        int cost;
-        // Get size of graph from filename
-        int endIdx = fileName.rfind('-');
-        int beginIdx = fileName.rfind('-', endIdx - 1);
-        int size = atoi(fileName.substr(beginIdx + 1, endIdx - beginIdx - 1).c_str());
-        if (size != lastSize && fileName != files[0]) {
-            std::cout << avgTime << ", " << reps << std::endl;
-            std::cout << lastSize << ", " << avgTime / reps << std::endl;
-            f << lastSize << ", " << avgTime / reps << "\n";
-            avgTime = 0;
-            reps = 0;
-        }
-        lastSize = size;
-
-
-        Graph g = Graph(fileName, opts);
-
-        double innerReps = 1;
-        if (size <= 100000) {
-            innerReps = 4;
-        }
-        if (size <= 10000) {
-            innerReps = 10;
-        }
-        if (size <= 1000) {
-            innerReps = 100;
-        }
-        for (size_t i = 0; i < innerReps; i++) {
-            // Time it
-            reps++;
-            double start, elapsed;
-            start = clock();
-            cost = g.Prim();
-            elapsed = (clock() - start) / CLOCKS_PER_SEC;
-            avgTime += elapsed;
-        }
-    }
-    std::cout << avgTime << ", " << reps << std::endl;
-    std::cout << lastSize << ", " << avgTime / reps << std::endl;
-    f << lastSize << ", " << avgTime / reps << "\n";
-
-    f.close();
-}
-
-
 void readInputs(int argc, char const* argv[]) {
     // Default to undirected and unweighted, matrix
     unsigned char options = 0;
+    bool convert = false;
+    bool forest = false;
+    bool stream = false;
+    std::string generate;
+    std::string perfFile;
+    std::string query;
+    size_t streamBytes = (size_t)64 << 20;
+    std::string coordinateFile;
     std::vector<std::string> files;
 
     for (int i = 1; i < argc; i++) {
@@ -277,6 +178,33 @@ void readInputs(int argc, char const* argv[]) {
             options |= OnlyPrint;
         } else if (strcmp(argv[i], "-l") == 0) {
             options |= UseList;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            options |= UseCSR;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            options |= FastLoad;
+        } else if (strcmp(argv[i], "-t") == 0) {
+            options |= ParallelLoad;
+        } else if (strcmp(argv[i], "-b") == 0) {
+            convert = true;
+        } else if (strcmp(argv[i], "-f") == 0) {
+            forest = true;
+        } else if (strcmp(argv[i], "-s") == 0) {
+            stream = true;
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            generate = argv[++i];
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+            perfFile = argv[++i];
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            int mib = atoi(argv[++i]);
+            if (mib <= 0) {
+                std::cerr << "Bad stream memory, expected MiB > 0: " << argv[i] << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            streamBytes = (size_t)mib << 20;
+        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+            query = argv[++i];
+        } else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc) {
+            coordinateFile = argv[++i];
         } else if (argv[i][0] == '-') {
             // Multi args
             if (strstr(argv[i], "d") != NULL)
@@ -289,6 +217,18 @@ void readInputs(int argc, char const* argv[]) {
                 options |= OnlyPrint;
             if (strstr(argv[i], "l") != NULL)
                 options |= UseList;
+            if (strstr(argv[i], "c") != NULL)
+                options |= UseCSR;
+            if (strstr(argv[i], "m") != NULL)
+                options |= FastLoad;
+            if (strstr(argv[i], "t") != NULL)
+                options |= ParallelLoad;
+            if (strstr(argv[i], "b") != NULL)
+                convert = true;
+            if (strstr(argv[i], "f") != NULL)
+                forest = true;
+            if (strstr(argv[i], "s") != NULL)
+                stream = true;
         } else if (argv[i][0] != '-') {
             files.push_back(argv[i]);
         } else {
@@ -300,24 +240,70 @@ void readInputs(int argc, char const* argv[]) {
             ss << "-e | Print edges when printing graphs\n";
             ss << "-p | Just print graphs\n";
             ss << "-l | Use adjacency list instead of a matrix\n";
+            ss << "-c | Use compressed sparse row storage instead of a matrix\n";
+            ss << "-m | Memory map input files instead of reading them line by line\n";
+            ss << "-t | Memory map input files and parse edges on every core\n";
+            ss << "-b | Convert input files to binary snapshots (<file>.bin) and exit\n";
+            ss << "-f | Write the minimum spanning forest of each file to <file>.forest.csv and exit\n";
+            ss << "-s | Stream each file's edges in bounded memory, print components and MST cost and exit\n";
+            ss << "-M MiB | Memory for the edges -s holds at once (default 64)\n";
+            ss << "-g model:V:E:seed[:minWeight:maxWeight[:weights]] | Generate a graph (er, rmat, grid, complete; uniform, exp or log weights) into the file and exit\n";
+            ss << "-q source:target | Print the shortest path between two vertices with each point to point query and exit\n";
+            ss << "-x FILE | Vertex coordinates (vertex x y per line) for the A* estimate of -q\n";
+            ss << "-P FILE | Write per phase hardware counters as CSV (make perf builds only)\n";
             std::cerr << ss.str() << std::endl;
         }
     }
-    // for (auto f : files) {
-    //     (options & OnlyPrint) ? printGraph(f, options) : processGraph(f, options);
-    // }
-
-    // Sort files by size
-    std::sort(files.begin(), files.end(), compareFileSize);
-    timePrimsAverage(files, options);
-    // timePrimsIndividual(files, options);
+    if (!generate.empty()) {
+        GeneratorOptions generator = ParseGeneratorSpec(generate);
+        generator.directed = options & Directed;
+        std::vector<Edge> edges = GenerateEdges(generator);
+        for (auto f : files) {
+            WriteGraph(f, generator.numV, edges, options & Weighted);
+            std::cout << f << ": " << generator.numV << " vertices, " << edges.size() << " edges" << std::endl;
+        }
+        return;
+    }
+    if (convert) {
+        for (auto f : files)
+            convertToBinary(f, options);
+        return;
+    }
+    if (forest) {
+        for (auto f : files)
+            writeForest(f, options);
+        return;
+    }
+    if (stream) {
+        for (auto f : files)
+            streamGraph(f, options, streamBytes);
+        return;
+    }
+    if (!query.empty()) {
+        for (auto f : files)
+            queryPath(f, options, query, coordinateFile);
+        return;
+    }
+    for (auto f : files) {
+        (options & OnlyPrint) ? printGraph(f, options) : processGraph(f, options);
+    }
 
+    if constexpr (collectStats)
+        DumpStats(std::cout);
+
+#if defined(GRAPH_PERF)
+    PerfProfiler::Instance().Report(std::cout);
+    if (!perfFile.empty())
+        PerfProfiler::Instance().WriteCSV(perfFile);
+#else
+    if (!perfFile.empty())
+        std::cerr << "Built without GRAPH_PERF; use make perf for hardware counters" << std::endl;
+#endif
 }
 
 int main(int argc, char const* argv[]) {
     readInputs(argc, argv);
     // testBinaryHeap();
-    //  timeBinaryHeap();
 
     return 0;
 }
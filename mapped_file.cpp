@@ -0,0 +1,49 @@
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mapped_file.h"
+
+MappedFile::MappedFile(std::string fileName)
+    : fd(-1), data(NULL), size(0) {
+    this->fd = open(fileName.c_str(), O_RDONLY);
+    struct stat st;
+    if (this->fd == -1 || fstat(this->fd, &st) == -1) {
+        std::cerr << "Error reading file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    this->size = st.st_size;
+    // Can't map an empty file
+    if (this->size == 0)
+        return;
+
+    void* mapped = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, this->fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Error mapping file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // Mostly forward scans, but CSR loading counts lines before parsing and parallel loading reads
+    // chunks at once, so ask for the whole file instead of sequential readahead that drops pages behind
+    madvise(mapped, this->size, MADV_WILLNEED);
+    this->data = static_cast<const char*>(mapped);
+}
+
+MappedFile::~MappedFile() {
+    if (this->data != NULL)
+        munmap(const_cast<char*>(this->data), this->size);
+    if (this->fd != -1)
+        close(this->fd);
+}
+
+const char* MappedFile::Begin() const {
+    return this->data;
+}
+
+const char* MappedFile::End() const {
+    return this->data + this->size;
+}
+
+size_t MappedFile::Size() const {
+    return this->size;
+}
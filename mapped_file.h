@@ -0,0 +1,27 @@
+#if !defined(MAPPED_FILE_H)
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    int fd;
+    const char* data;
+    size_t size;
+
+public:
+    // Maps the file, exits if it can't be opened
+    MappedFile(std::string fileName);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* Begin() const;
+    const char* End() const;
+    size_t Size() const;
+};
+
+#endif // MAPPED_FILE_H
@@ -1,28 +1,24 @@
 #include <iostream>
 #include <iomanip>
 #include "min_heap.h"
+#include "stats.h"
 
 MinHeap::MinHeap(int capacity) {
     this->capacity = capacity;
     this->size = 0;
-    this->IDs = std::vector<int>(capacity);
-    this->keys = std::vector<int>(capacity);
+    this->heap = std::vector<Element>(capacity);
     this->indices = std::vector<int>(capacity);
 }
 
 MinHeap::MinHeap(std::vector<Element> arr) {
     this->capacity = this->size = arr.size();
-    this->IDs = std::vector<int>(capacity);
-    this->keys = std::vector<int>(capacity);
+    this->heap = arr;
     this->indices = std::vector<int>(capacity);
     for (int i = 0; i < this->capacity; i++) {
-        Element el = arr[i];
-        this->IDs[i] = el.ID;
-        this->keys[i] = el.key;
-        this->indices[el.ID] = i;
+        this->indices[arr[i].ID] = i;
     }
     for (int i = arr.size() - 1; i >= 0; i--) {
-        this->SiftDown(Element{ this->IDs[i], this->keys[i] }, i);
+        this->SiftDown(this->heap[i], i);
     }
 }
 
@@ -54,14 +50,19 @@ void MinHeap::DecreaseKey(int ID, int newKey) {
     // Don't do anything if ID was popped
     if (this->Index(ID) == -1)
         return;
-    this->BubbleUp(Element{ ID, newKey }, this->Index(ID));
+    int index = this->Index(ID);
+    this->BubbleUp(Element{ ID, newKey }, index);
+    if constexpr (collectStats) {
+        Stats().decreaseKeys++;
+        Stats().decreaseKeysMoved += this->Index(ID) != index;
+    }
 }
 
 int MinHeap::DeleteMin() {
     if (this->size != 0) {
-        Element e = Element{ this->IDs[0], this->keys[0] };
+        Element e = this->heap[0];
         this->size--;
-        this->SiftDown(Element{ this->IDs[this->size], this->keys[this->size] }, 0);
+        this->SiftDown(this->heap[this->size], 0);
         // Set index to -1
         this->indices[e.ID] = -1;
         return e.ID;
@@ -73,32 +74,34 @@ int MinHeap::DeleteMin() {
 
 void MinHeap::BubbleUp(Element e, int index) {
     int p = this->Parent(index);
-    while (index > 0 && this->keys[p] > e.key) {
-        int pid = this->IDs[p];
-        this->IDs[index] = pid;
-        this->keys[index] = this->keys[p];
-        this->indices[pid] = index;
+    while (index > 0 && this->heap[p].key > e.key) {
+        this->heap[index] = this->heap[p];
+        this->indices[this->heap[index].ID] = index;
         index = p;
         p = this->Parent(index);
+        if constexpr (collectStats)
+            Stats().bubbleUpLevels++;
     }
-    this->IDs[index] = e.ID;
-    this->keys[index] = e.key;
+    this->heap[index] = e;
     this->indices[e.ID] = index;
+    if constexpr (collectStats)
+        Stats().bubbleUps++;
 }
 
 void MinHeap::SiftDown(Element e, int index) {
     int c = this->MinChild(index);
-    while (c > 0 && this->keys[c] < e.key) {
-        int cid = this->IDs[c];
-        this->IDs[index] = cid;
-        this->keys[index] = this->keys[c];
-        this->indices[cid] = index;
+    while (c > 0 && this->heap[c].key < e.key) {
+        this->heap[index] = this->heap[c];
+        this->indices[this->heap[index].ID] = index;
         index = c;
         c = this->MinChild(index);
+        if constexpr (collectStats)
+            Stats().siftDownLevels++;
     }
-    this->IDs[index] = e.ID;
-    this->keys[index] = e.key;
+    this->heap[index] = e;
     this->indices[e.ID] = index;
+    if constexpr (collectStats)
+        Stats().siftDowns++;
 }
 
 int MinHeap::MinChild(int index) {
@@ -116,7 +119,7 @@ int MinHeap::Index(int ID) {
 }
 
 int MinHeap::MinIndex(int a, int b) {
-    return this->keys[a] < this->keys[b] ? a : b;
+    return this->heap[a].key < this->heap[b].key ? a : b;
 }
 
 int MinHeap::Parent(int idx) {
@@ -140,12 +143,12 @@ std::ostream& operator<<(std::ostream& out, const MinHeap& h) {
     out << "\n" << std::string(10 + h.capacity * 5, '-') << "\n";
     out << std::setw(10) << "IDs: ";
     for (int i = 0; i < h.size; i++) {
-        out << std::setw(4) << h.IDs[i] << " ";
+        out << std::setw(4) << h.heap[i].ID << " ";
     }
     out << "\n";
     out << std::setw(10) << "Keys: ";
     for (int i = 0; i < h.size; i++) {
-        out << std::setw(4) << h.keys[i] << " ";
+        out << std::setw(4) << h.heap[i].key << " ";
     }
     out << "\n";
     out << std::setw(10) << "Indices: ";
@@ -2,6 +2,7 @@
 #define MIN_HEAP_H
 
 #include <vector>
+#include <iostream>
 
 struct Element {
     int ID;
@@ -12,8 +13,8 @@ class MinHeap {
 private:
     int capacity; // Max size
     int size; // Current size
-    std::vector<int> IDs; // Contains the IDs of elements
-    std::vector<int> keys; // Contains the keys of elements
+    // ID and key side by side so a comparison and the following move touch one cache line
+    std::vector<Element> heap;
     std::vector<int> indices; // Map data ID to index
 
     int MinIndex(int a, int b);
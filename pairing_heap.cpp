@@ -0,0 +1,118 @@
+#include <iostream>
+#include "pairing_heap.h"
+#include "stats.h"
+
+PairingHeap::PairingHeap(int capacity)
+    : capacity(capacity), size(0), root(-1),
+    keys(capacity), child(capacity, -1), next(capacity, -1), prev(capacity, -1), inHeap(capacity, false) {}
+
+PairingHeap::PairingHeap(std::vector<Element> arr)
+    : PairingHeap(arr.size()) {
+    for (auto el : arr) {
+        this->Insert(el);
+    }
+}
+
+int PairingHeap::Size() {
+    return this->size;
+}
+
+void PairingHeap::Insert(Element el) {
+    if (this->size == this->capacity) {
+        // Full
+        std::cout << "error: cannot insert; heap is full" << std::endl;
+        return;
+    }
+    this->keys[el.ID] = el.key;
+    this->child[el.ID] = this->next[el.ID] = this->prev[el.ID] = -1;
+    this->inHeap[el.ID] = true;
+    this->root = this->root == -1 ? el.ID : this->Link(this->root, el.ID);
+    this->size++;
+}
+
+void PairingHeap::DecreaseKey(int ID, int newKey) {
+    // Don't do anything if ID was popped
+    if (ID >= this->capacity || !this->inHeap[ID])
+        return;
+    this->keys[ID] = newKey;
+    if constexpr (collectStats)
+        Stats().decreaseKeys++;
+    if (ID == this->root)
+        return;
+    this->Cut(ID);
+    this->root = this->Link(this->root, ID);
+    // The subtree moves up to just under the root in one step
+    if constexpr (collectStats) {
+        Stats().decreaseKeysMoved++;
+        Stats().bubbleUps++;
+        Stats().bubbleUpLevels++;
+    }
+}
+
+int PairingHeap::DeleteMin() {
+    if (this->size == 0) {
+        // Empty
+        std::cout << "error: cannot delete min; heap is empty" << std::endl;
+        return -1;
+    }
+    int min = this->root;
+    this->inHeap[min] = false;
+    this->size--;
+
+    // First pass: link children in pairs from left to right
+    this->pairs.clear();
+    int c = this->child[min];
+    while (c != -1) {
+        int a = c;
+        int b = this->next[a];
+        c = b == -1 ? -1 : this->next[b];
+        this->next[a] = this->prev[a] = -1;
+        if (b != -1) {
+            this->next[b] = this->prev[b] = -1;
+            a = this->Link(a, b);
+            if constexpr (collectStats)
+                Stats().siftDownLevels++;
+        }
+        this->pairs.push_back(a);
+    }
+    // Second pass: link the pairs from right to left
+    int newRoot = -1;
+    for (int i = this->pairs.size() - 1; i >= 0; i--) {
+        newRoot = newRoot == -1 ? this->pairs[i] : this->Link(newRoot, this->pairs[i]);
+    }
+    this->root = newRoot;
+    // Counted as one sift down whose depth is the links merging the children
+    if constexpr (collectStats) {
+        Stats().siftDowns++;
+        Stats().siftDownLevels += this->pairs.empty() ? 0 : this->pairs.size() - 1;
+    }
+    this->child[min] = -1;
+    return min;
+}
+
+int PairingHeap::Link(int a, int b) {
+    if (this->keys[b] < this->keys[a]) {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+    // b becomes the leftmost child of a
+    this->next[b] = this->child[a];
+    if (this->child[a] != -1)
+        this->prev[this->child[a]] = b;
+    this->prev[b] = a;
+    this->child[a] = b;
+    this->next[a] = this->prev[a] = -1;
+    return a;
+}
+
+void PairingHeap::Cut(int ID) {
+    int p = this->prev[ID];
+    if (this->child[p] == ID)
+        this->child[p] = this->next[ID];
+    else
+        this->next[p] = this->next[ID];
+    if (this->next[ID] != -1)
+        this->prev[this->next[ID]] = p;
+    this->next[ID] = this->prev[ID] = -1;
+}
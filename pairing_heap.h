@@ -0,0 +1,42 @@
+#if !defined(PAIRING_HEAP_H)
+#define PAIRING_HEAP_H
+
+#include <vector>
+#include "min_heap.h"
+
+// Indexed pairing heap; same interface as MinHeap.
+// DecreaseKey cuts the node's subtree and links it with the root in O(1),
+// DeleteMin does the standard two-pass pairing of the root's children.
+class PairingHeap {
+private:
+    int capacity; // Max size
+    int size; // Current size
+    int root; // ID at the root, -1 if empty
+    // Per ID node fields
+    std::vector<int> keys;
+    std::vector<int> child; // Leftmost child
+    std::vector<int> next; // Right sibling
+    std::vector<int> prev; // Left sibling, or parent for a leftmost child
+    std::vector<bool> inHeap;
+    std::vector<int> pairs; // Scratch space for DeleteMin
+
+    // Makes the root with the larger key the leftmost child of the other; returns the new root
+    int Link(int a, int b);
+    // Removes the node and its subtree from its parent's child list
+    void Cut(int ID);
+
+public:
+    // Empty heap with specified capacity
+    PairingHeap(int capacity);
+    // Intialize heap from existing array
+    PairingHeap(std::vector<Element> arr);
+
+    int Size();
+
+    void Insert(Element el);
+    void DecreaseKey(int ID, int newKey);
+    // Return -1 if no elements
+    int DeleteMin();
+};
+
+#endif // PAIRING_HEAP_H
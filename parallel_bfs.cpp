@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "graph.h"
+#include "thread_pool.h"
+
+// Beamer's switching thresholds: go bottom-up once the frontier's edges exceed
+// the unexplored edges / alpha, return top-down once the frontier drops below V / beta
+static const int alpha = 15;
+static const int beta = 18;
+// Levels with less work than this (frontier edges top-down, vertices bottom-up) run on the
+// calling thread, since waking the pool costs more than the scan
+static const long long minParallelWork = 4096;
+
+ShortestPathResult Graph::DirectionOptimizingBFS(int startVertexIndex, ThreadPool& pool) const {
+    // Correct for 1 indexing
+    startVertexIndex--;
+
+    int numTasks = pool.Size();
+    int numWords = (this->numV + 63) / 64;
+
+    // The bottom-up step of a directed graph walks the reverse edges, built once per graph
+    std::shared_ptr<const ReverseEdges> reverse;
+    if (this->opts & Directed)
+        reverse = this->ReverseEdgesOf();
+
+    std::vector<std::atomic<int>> parent(this->numV);
+    for (auto& p : parent)
+        p.store(-1, std::memory_order_relaxed);
+    std::vector<int> depth(this->numV, INT32_MAX);
+    parent[startVertexIndex].store(startVertexIndex);
+    depth[startVertexIndex] = 0;
+
+    std::vector<int> queue{ startVertexIndex };
+    std::vector<uint64_t> frontier(numWords, 0);
+    std::vector<uint64_t> next(numWords, 0);
+    bool bottomUp = false;
+    long long unexploredEdges = this->numE;
+
+    std::vector<std::vector<int>> found(numTasks);
+    std::vector<long long> foundCount(numTasks);
+    int level = 0;
+    long long frontierSize = 1;
+
+    auto runTasks = [&](int tasks, const std::function<void(int)>& task) {
+        if (tasks == 1)
+            task(0);
+        else
+            pool.Run(tasks, task);
+    };
+
+    while (frontierSize > 0) {
+        // Choose the direction for this level
+        long long frontierEdges = INT64_MAX;
+        if (!bottomUp) {
+            frontierEdges = 0;
+            for (int v : queue)
+                frontierEdges += this->OutDegree(v);
+            unexploredEdges -= frontierEdges;
+            if (frontierEdges > unexploredEdges / alpha) {
+                bottomUp = true;
+                std::fill(frontier.begin(), frontier.end(), 0);
+                for (int v : queue)
+                    frontier[v / 64] |= (uint64_t)1 << (v % 64);
+            }
+        } else if (frontierSize < this->numV / beta) {
+            bottomUp = false;
+            queue.clear();
+            for (int w = 0; w < numWords; w++) {
+                for (uint64_t bits = frontier[w]; bits != 0; bits &= bits - 1)
+                    queue.push_back(w * 64 + __builtin_ctzll(bits));
+            }
+        }
+
+        if (bottomUp) {
+            // Every unvisited vertex looks for a parent in the frontier; each task owns whole words
+            int tasks = this->numV < minParallelWork ? 1 : numTasks;
+            std::fill(foundCount.begin(), foundCount.end(), 0);
+            runTasks(tasks, [&](int t) {
+                int firstWord = (long long)numWords * t / tasks;
+                int lastWord = (long long)numWords * (t + 1) / tasks;
+                long long count = 0;
+                for (int w = firstWord; w < lastWord; w++) {
+                    uint64_t bits = 0;
+                    int end = w * 64 + 64 < this->numV ? w * 64 + 64 : this->numV;
+                    for (int v = w * 64; v < end; v++) {
+                        if (parent[v].load(std::memory_order_relaxed) != -1)
+                            continue;
+                        int p = -1;
+                        auto inFrontier = [&](int u) {
+                            if (frontier[u / 64] >> (u % 64) & 1) {
+                                p = u;
+                                return true;
+                            }
+                            return false;
+                        };
+                        if (this->opts & Directed) {
+                            for (int e = reverse->offsets[v]; e < reverse->offsets[v + 1] && !inFrontier(reverse->from[e]); e++) {}
+                        } else if (this->UseBits()) {
+                            // The row is v's neighbor set, so AND it with the frontier a word at a time
+                            const uint64_t* row = this->BitRow(v);
+                            for (int u = 0; u < numWords; u++) {
+                                uint64_t hit = row[u] & frontier[u];
+                                if (hit != 0) {
+                                    p = u * 64 + __builtin_ctzll(hit);
+                                    break;
+                                }
+                            }
+                        } else {
+                            this->AnyNeighbor(v, [&](int u, int) { return inFrontier(u); });
+                        }
+                        if (p != -1) {
+                            parent[v].store(p, std::memory_order_relaxed);
+                            depth[v] = level + 1;
+                            bits |= (uint64_t)1 << (v % 64);
+                            count++;
+                        }
+                    }
+                    next[w] = bits;
+                }
+                foundCount[t] = count;
+            });
+            frontier.swap(next);
+            frontierSize = 0;
+            for (long long c : foundCount)
+                frontierSize += c;
+        } else {
+            // Frontier vertices claim their unvisited neighbors
+            int tasks = frontierEdges < minParallelWork ? 1 : numTasks;
+            auto claim = [&](int t) {
+                size_t first = queue.size() * t / tasks;
+                size_t last = queue.size() * (t + 1) / tasks;
+                for (size_t i = first; i < last; i++) {
+                    int from = queue[i];
+                    this->ForEachNeighbor(from, [&](int to, int) {
+                        int unclaimed = -1;
+                        if (parent[to].load(std::memory_order_relaxed) == -1 &&
+                            parent[to].compare_exchange_strong(unclaimed, from, std::memory_order_relaxed)) {
+                            depth[to] = level + 1;
+                            found[t].push_back(to);
+                        }
+                    });
+                }
+            };
+            runTasks(tasks, claim);
+            queue.clear();
+            for (auto& list : found) {
+                queue.insert(queue.end(), list.begin(), list.end());
+                list.clear();
+            }
+            frontierSize = queue.size();
+        }
+        level++;
+    }
+
+    ShortestPathResult result(startVertexIndex, this->numV);
+    result.distance.swap(depth);
+    for (int v = 0; v < this->numV; v++) {
+        if (v != startVertexIndex)
+            result.prev[v] = parent[v].load(std::memory_order_relaxed);
+    }
+    return result;
+}
@@ -0,0 +1,360 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* phaseNames[NumPerfPhases] = { "load", "heap-build", "search", "delete-min", "relax" };
+static const char* eventNames[NumPerfEvents] = { "cycles", "instructions", "llc-misses", "branch-misses" };
+
+// Phases bracketed once per vertex; they are only counted where the counters can be read without a system call
+static bool IsPerVertex(int phase) {
+    return phase == PhaseDeleteMin || phase == PhaseRelax;
+}
+
+#if defined(__linux__)
+// Opens a counter for the calling thread in the leader's group, or as the leader when there is none yet
+static int OpenCounter(uint32_t type, uint64_t config, int leader) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // User space only, so it works with perf_event_paranoid up to 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // One read of the leader returns every counter of the group
+    attr.read_format = PERF_FORMAT_GROUP;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline uint64_t Rdpmc(uint32_t counter) {
+    uint32_t low, high;
+    __asm__ volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(counter));
+    return (uint64_t)high << 32 | low;
+}
+
+// Reads a counter through its mmap'd page, retrying if the kernel updated the page meanwhile.
+// False when the event isn't on a hardware counter right now or user reads are off
+static bool ReadUser(const perf_event_mmap_page* page, long long& count) {
+    uint32_t seq;
+    int64_t value;
+    do {
+        seq = page->lock;
+        __asm__ volatile("" ::: "memory");
+        uint32_t index = page->index;
+        if (!page->cap_user_rdpmc || index == 0)
+            return false;
+        // The hardware counter is pmc_width bits wide and sign extended onto offset
+        int64_t pmc = Rdpmc(index - 1);
+        int shift = 64 - page->pmc_width;
+        value = page->offset + (pmc << shift >> shift);
+        __asm__ volatile("" ::: "memory");
+    } while (page->lock != seq);
+    count = value;
+    return true;
+}
+#else
+static bool ReadUser(const perf_event_mmap_page*, long long&) {
+    return false;
+}
+#endif
+#endif
+
+// Counters and running totals of one thread. Only the owning thread writes the totals; they are
+// relaxed atomics so a report from another thread reads them without a data race
+struct PerfThread {
+    int fds[NumPerfEvents]; // -1 where the event couldn't be opened
+    int slots[NumPerfEvents]; // Position of each open event in a group read
+    int leader;
+    int numOpen;
+#if defined(__linux__)
+    perf_event_mmap_page* pages[NumPerfEvents];
+#endif
+    size_t pageBytes;
+    bool userRead; // Every open counter can be read with rdpmc
+
+    int depth[NumPerfPhases]; // Nesting of Begin calls; only the outermost pair counts
+    long long startCounts[NumPerfPhases][NumPerfEvents];
+    std::chrono::steady_clock::time_point startTimes[NumPerfPhases];
+    std::atomic<long long> counts[NumPerfPhases][NumPerfEvents];
+    std::atomic<double> seconds[NumPerfPhases];
+    std::atomic<long long> calls[NumPerfPhases];
+
+    PerfThread();
+    ~PerfThread();
+    // Group read with a system call; zeros if nothing opened
+    void Read(long long values[NumPerfEvents]) const;
+    // rdpmc reads, falling back to Read if any counter isn't readable at the moment
+    void ReadFast(long long values[NumPerfEvents]) const;
+    void Add(PerfTotals totals[NumPerfPhases]) const;
+    void Clear();
+};
+
+static PerfThread& ThisThread() {
+    thread_local PerfThread counters;
+    return counters;
+}
+
+PerfThread::PerfThread() : leader(-1), numOpen(0), pageBytes(0), userRead(false) {
+    for (int e = 0; e < NumPerfEvents; e++)
+        this->fds[e] = -1;
+#if defined(__linux__)
+    const uint64_t configs[NumPerfEvents] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    this->pageBytes = sysconf(_SC_PAGESIZE);
+    this->userRead = true;
+    for (int e = 0; e < NumPerfEvents; e++) {
+        this->pages[e] = NULL;
+        this->fds[e] = OpenCounter(PERF_TYPE_HARDWARE, configs[e], this->leader);
+        if (this->fds[e] == -1)
+            continue;
+        if (this->leader == -1)
+            this->leader = this->fds[e];
+        this->slots[e] = this->numOpen++;
+        // The first page of the mapping says whether and how rdpmc can read the counter
+        void* page = mmap(NULL, this->pageBytes, PROT_READ, MAP_SHARED, this->fds[e], 0);
+        if (page == MAP_FAILED) {
+            this->userRead = false;
+            continue;
+        }
+        this->pages[e] = static_cast<perf_event_mmap_page*>(page);
+        long long unused;
+        if (!this->pages[e]->cap_user_rdpmc || !ReadUser(this->pages[e], unused))
+            this->userRead = false;
+    }
+#endif
+    if (this->numOpen == 0)
+        this->userRead = false;
+    this->Clear();
+    for (int p = 0; p < NumPerfPhases; p++)
+        this->depth[p] = 0;
+
+    PerfProfiler& profiler = PerfProfiler::Instance();
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    profiler.threads.push_back(this);
+    for (int e = 0; e < NumPerfEvents; e++)
+        profiler.opened[e] |= this->fds[e] != -1;
+    if (this->numOpen == 0 && !profiler.warned) {
+        std::cerr << "Hardware counters unavailable (check /proc/sys/kernel/perf_event_paranoid); reporting wall time only" << std::endl;
+        profiler.warned = true;
+    }
+}
+
+PerfThread::~PerfThread() {
+    // Keep what this thread counted after it exits
+    PerfProfiler& profiler = PerfProfiler::Instance();
+    {
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        this->Add(profiler.retired);
+        for (size_t i = 0; i < profiler.threads.size(); i++) {
+            if (profiler.threads[i] == this) {
+                profiler.threads.erase(profiler.threads.begin() + i);
+                break;
+            }
+        }
+    }
+#if defined(__linux__)
+    for (int e = 0; e < NumPerfEvents; e++) {
+        if (this->pages[e] != NULL)
+            munmap(this->pages[e], this->pageBytes);
+        if (this->fds[e] != -1)
+            close(this->fds[e]);
+    }
+#endif
+}
+
+void PerfThread::Read(long long values[NumPerfEvents]) const {
+    for (int e = 0; e < NumPerfEvents; e++)
+        values[e] = 0;
+#if defined(__linux__)
+    if (this->numOpen == 0)
+        return;
+    // Number of counters, then their values in the order they were opened
+    uint64_t group[1 + NumPerfEvents];
+    ssize_t size = sizeof(uint64_t) * (1 + this->numOpen);
+    if (read(this->leader, group, size) != size)
+        return;
+    for (int e = 0; e < NumPerfEvents; e++) {
+        if (this->fds[e] != -1)
+            values[e] = group[1 + this->slots[e]];
+    }
+#endif
+}
+
+void PerfThread::ReadFast(long long values[NumPerfEvents]) const {
+#if defined(__linux__)
+    for (int e = 0; e < NumPerfEvents; e++) {
+        values[e] = 0;
+        if (this->fds[e] != -1 && !ReadUser(this->pages[e], values[e])) {
+            // Rare: the event was just moved off its hardware counter
+            this->Read(values);
+            return;
+        }
+    }
+#else
+    this->Read(values);
+#endif
+}
+
+void PerfThread::Add(PerfTotals totals[NumPerfPhases]) const {
+    for (int p = 0; p < NumPerfPhases; p++) {
+        for (int e = 0; e < NumPerfEvents; e++)
+            totals[p].counts[e] += this->counts[p][e].load(std::memory_order_relaxed);
+        totals[p].seconds += this->seconds[p].load(std::memory_order_relaxed);
+        totals[p].calls += this->calls[p].load(std::memory_order_relaxed);
+    }
+}
+
+void PerfThread::Clear() {
+    for (int p = 0; p < NumPerfPhases; p++) {
+        for (int e = 0; e < NumPerfEvents; e++)
+            this->counts[p][e].store(0, std::memory_order_relaxed);
+        this->seconds[p].store(0, std::memory_order_relaxed);
+        this->calls[p].store(0, std::memory_order_relaxed);
+    }
+}
+
+PerfProfiler::PerfProfiler() : warned(false) {
+    for (int e = 0; e < NumPerfEvents; e++)
+        this->opened[e] = false;
+    for (int p = 0; p < NumPerfPhases; p++)
+        this->retired[p] = PerfTotals{ { 0, 0, 0, 0 }, 0, 0 };
+}
+
+PerfProfiler& PerfProfiler::Instance() {
+    static PerfProfiler profiler;
+    return profiler;
+}
+
+void PerfProfiler::Begin(PerfPhase phase) {
+    PerfThread& t = ThisThread();
+    if (t.depth[phase]++ > 0)
+        return;
+    if (IsPerVertex(phase)) {
+        if (!t.userRead)
+            return;
+        t.startTimes[phase] = std::chrono::steady_clock::now();
+        t.ReadFast(t.startCounts[phase]);
+        return;
+    }
+    t.startTimes[phase] = std::chrono::steady_clock::now();
+    t.Read(t.startCounts[phase]);
+}
+
+void PerfProfiler::End(PerfPhase phase) {
+    PerfThread& t = ThisThread();
+    if (--t.depth[phase] > 0)
+        return;
+    long long values[NumPerfEvents];
+    if (IsPerVertex(phase)) {
+        if (!t.userRead)
+            return;
+        t.ReadFast(values);
+    } else {
+        t.Read(values);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t.startTimes[phase]).count();
+
+    // Single writer, so a relaxed load and store is enough
+    for (int e = 0; e < NumPerfEvents; e++) {
+        std::atomic<long long>& c = t.counts[phase][e];
+        c.store(c.load(std::memory_order_relaxed) + values[e] - t.startCounts[phase][e], std::memory_order_relaxed);
+    }
+    t.seconds[phase].store(t.seconds[phase].load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    t.calls[phase].store(t.calls[phase].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void PerfProfiler::Reset() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (int p = 0; p < NumPerfPhases; p++)
+        this->retired[p] = PerfTotals{ { 0, 0, 0, 0 }, 0, 0 };
+    for (PerfThread* t : this->threads)
+        t->Clear();
+}
+
+void PerfProfiler::Totals(PerfTotals totals[NumPerfPhases], bool opened[NumPerfEvents]) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (int p = 0; p < NumPerfPhases; p++)
+        totals[p] = this->retired[p];
+    for (PerfThread* t : this->threads)
+        t->Add(totals);
+    for (int e = 0; e < NumPerfEvents; e++)
+        opened[e] = this->opened[e];
+}
+
+void PerfProfiler::Report(std::ostream& out) {
+    PerfTotals totals[NumPerfPhases];
+    bool opened[NumPerfEvents];
+    this->Totals(totals, opened);
+
+    out << std::left << std::setw(12) << "phase" << std::right << std::setw(12) << "calls" << std::setw(14) << "seconds";
+    for (int e = 0; e < NumPerfEvents; e++)
+        out << std::setw(16) << eventNames[e];
+    out << std::setw(8) << "IPC" << "\n";
+
+    for (int p = 0; p < NumPerfPhases; p++) {
+        const PerfTotals& t = totals[p];
+        if (t.calls == 0)
+            continue;
+        out << std::left << std::setw(12) << phaseNames[p] << std::right << std::setw(12) << t.calls
+            << std::setw(14) << std::fixed << std::setprecision(6) << t.seconds;
+        for (int e = 0; e < NumPerfEvents; e++) {
+            if (!opened[e])
+                out << std::setw(16) << "n/a";
+            else
+                out << std::setw(16) << t.counts[e];
+        }
+        if (opened[EventCycles] && opened[EventInstructions] && t.counts[EventCycles] > 0)
+            out << std::setw(8) << std::setprecision(2) << (double)t.counts[EventInstructions] / t.counts[EventCycles];
+        else
+            out << std::setw(8) << "n/a";
+        out << "\n";
+    }
+    if (totals[PhaseSearch].calls > 0 && totals[PhaseDeleteMin].calls == 0)
+        out << "delete-min and relax need rdpmc access to the counters; only whole phases were counted\n";
+    out << std::defaultfloat;
+}
+
+void PerfProfiler::WriteCSV(std::string fileName) {
+    std::ofstream f(fileName);
+    if (!f.good()) {
+        std::cerr << "Error writing file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    PerfTotals totals[NumPerfPhases];
+    bool opened[NumPerfEvents];
+    this->Totals(totals, opened);
+
+    f << "phase,calls,seconds";
+    for (int e = 0; e < NumPerfEvents; e++)
+        f << "," << eventNames[e];
+    f << "\n" << std::setprecision(9);
+    for (int p = 0; p < NumPerfPhases; p++) {
+        const PerfTotals& t = totals[p];
+        if (t.calls == 0)
+            continue;
+        f << phaseNames[p] << "," << t.calls << "," << t.seconds;
+        // Empty where the counter couldn't be opened
+        for (int e = 0; e < NumPerfEvents; e++) {
+            f << ",";
+            if (opened[e])
+                f << t.counts[e];
+        }
+        f << "\n";
+    }
+}
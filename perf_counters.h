@@ -0,0 +1,90 @@
+#if !defined(PERF_COUNTERS_H)
+#define PERF_COUNTERS_H
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Hardware counters per algorithm phase, read with Linux perf_event_open.
+// Only compiled into the algorithms with -DGRAPH_PERF (make perf); otherwise the
+// PERF_ macros expand to nothing and the hot loops are untouched
+
+enum PerfPhase {
+    PhaseLoad, // Graph construction from a file or edges, including parsing on pool threads
+    PhaseHeapBuild, // Building the heap for Dijkstra/Prim
+    PhaseSearch, // The whole DeleteMin/relax loop of Dijkstra/Prim
+    PhaseDeleteMin, // DeleteMin calls of the main loop (per vertex, needs rdpmc)
+    PhaseRelax, // Scanning neighbors and DecreaseKey (per vertex, needs rdpmc)
+    NumPerfPhases,
+};
+
+enum PerfEvent {
+    EventCycles,
+    EventInstructions,
+    EventLLCMisses,
+    EventBranchMisses,
+    NumPerfEvents,
+};
+
+struct PerfTotals {
+    long long counts[NumPerfEvents];
+    double seconds; // Summed over threads
+    long long calls; // Begin/End pairs
+};
+
+struct PerfThread;
+
+// Every thread that begins a phase opens its own group of user space counters, which count only
+// that thread; the report adds up all threads. Whole phases read the group with one system call at
+// each end. The per vertex phases (DeleteMin, Relax) read the counters with rdpmc through the mmap'd
+// perf page instead, and are skipped on threads where the kernel or CPU doesn't allow that, so no
+// system call lands inside the loops being measured
+class PerfProfiler {
+private:
+    std::mutex mutex; // Guards threads, retired and opened
+    std::vector<PerfThread*> threads; // Threads with open counters
+    PerfTotals retired[NumPerfPhases]; // Totals of threads that have exited
+    bool opened[NumPerfEvents]; // Whether the event opened on any thread
+    bool warned;
+
+    PerfProfiler();
+    // Sums retired and live threads
+    void Totals(PerfTotals totals[NumPerfPhases], bool opened[NumPerfEvents]);
+
+    friend struct PerfThread;
+
+public:
+    static PerfProfiler& Instance();
+
+    void Begin(PerfPhase phase);
+    void End(PerfPhase phase);
+    // Reset and the reports expect no phase to be running on any thread
+    void Reset();
+
+    // Table of every phase that ran; counters that couldn't be opened show as n/a
+    void Report(std::ostream& out);
+    void WriteCSV(std::string fileName);
+};
+
+// Begin on construction, End when it goes out of scope
+class PerfScope {
+private:
+    PerfPhase phase;
+
+public:
+    PerfScope(PerfPhase phase) : phase(phase) { PerfProfiler::Instance().Begin(phase); }
+    ~PerfScope() { PerfProfiler::Instance().End(this->phase); }
+};
+
+#if defined(GRAPH_PERF)
+#define PERF_BEGIN(phase) PerfProfiler::Instance().Begin(phase)
+#define PERF_END(phase) PerfProfiler::Instance().End(phase)
+#define PERF_SCOPE(phase) PerfScope perfScope(phase)
+#else
+#define PERF_BEGIN(phase)
+#define PERF_END(phase)
+#define PERF_SCOPE(phase)
+#endif
+
+#endif // PERF_COUNTERS_H
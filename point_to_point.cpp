@@ -0,0 +1,288 @@
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "graph.h"
+#include "min_heap.h"
+#include "d_ary_heap.h"
+#include "pairing_heap.h"
+#include "radix_heap.h"
+
+std::shared_ptr<const ReverseEdges> Graph::ReverseEdgesOf() const {
+    ReverseEdgesCache& cache = *this->reverseEdges;
+    std::call_once(cache.built, [&] {
+        // Counting sort of every edge on its destination
+        auto reverse = std::make_shared<ReverseEdges>();
+        reverse->offsets.assign(this->numV + 1, 0);
+        for (int v = 0; v < this->numV; v++) {
+            this->ForEachNeighbor(v, [&](int to, int) { reverse->offsets[to + 1]++; });
+        }
+        for (int v = 0; v < this->numV; v++) {
+            reverse->offsets[v + 1] += reverse->offsets[v];
+        }
+        reverse->from.resize(reverse->offsets[this->numV]);
+        reverse->weights.resize(reverse->offsets[this->numV]);
+        std::vector<int> next(reverse->offsets.begin(), reverse->offsets.end() - 1);
+        for (int v = 0; v < this->numV; v++) {
+            this->ForEachNeighbor(v, [&](int to, int weight) {
+                reverse->from[next[to]] = v;
+                reverse->weights[next[to]] = weight;
+                next[to]++;
+            });
+        }
+        cache.edges = reverse;
+    });
+    return cache.edges;
+}
+
+// Walks prev back from the target; vertices come out 1-indexed, source first
+static std::vector<int> TracePath(const std::vector<int32_t>& prev, int target) {
+    std::vector<int> path;
+    for (int v = target; v != -1; v = prev[v]) {
+        path.push_back(v + 1);
+    }
+    return std::vector<int>(path.rbegin(), path.rend());
+}
+
+template <typename Heap>
+PathResult Graph::ShortestPath(int source, int target) const {
+    PathResult result{ INT32_MAX, {}, 0 };
+    if (!this->IsVertex(source) || !this->IsVertex(target))
+        return result;
+    // Correct for 1 indexing
+    source--;
+    target--;
+
+    // Vertices enter the heap when first reached and the search stops at the target, so a query near
+    // the source settles few vertices; the arrays below still cost O(V) to set up per query
+    std::vector<int32_t> distance(this->numV, INT32_MAX);
+    std::vector<int32_t> prev(this->numV, -1);
+    Heap heap(this->numV);
+    distance[source] = 0;
+    heap.Insert(Element{ source, 0 });
+
+    while (heap.Size() > 0) {
+        int currIdx = heap.DeleteMin();
+        result.settled++;
+        // Settled, so no shorter path exists
+        if (currIdx == target)
+            break;
+
+        int dist = distance[currIdx];
+        this->ForEachNeighbor(currIdx, [&](int to, int weight) {
+            int newDist = dist + weight;
+            if (distance[to] == INT32_MAX) {
+                distance[to] = newDist;
+                prev[to] = currIdx;
+                heap.Insert(Element{ to, newDist });
+            } else if (newDist < distance[to]) {
+                distance[to] = newDist;
+                prev[to] = currIdx;
+                heap.DecreaseKey(to, newDist);
+            }
+        });
+    }
+
+    if (distance[target] != INT32_MAX) {
+        result.distance = distance[target];
+        result.path = TracePath(prev, target);
+    }
+    return result;
+}
+
+template <typename Heap>
+PathResult Graph::BidirectionalDijkstra(int source, int target) const {
+    PathResult result{ INT32_MAX, {}, 0 };
+    if (!this->IsVertex(source) || !this->IsVertex(target))
+        return result;
+    // Correct for 1 indexing
+    source--;
+    target--;
+
+    // Undirected graphs search backwards over the same edges
+    std::shared_ptr<const ReverseEdges> reverse;
+    if (this->opts & Directed)
+        reverse = this->ReverseEdgesOf();
+    auto forEachInEdge = [&](int v, auto visit) {
+        if (!reverse) {
+            this->ForEachNeighbor(v, visit);
+            return;
+        }
+        for (int e = reverse->offsets[v]; e < reverse->offsets[v + 1]; e++) {
+            visit(reverse->from[e], reverse->weights[e]);
+        }
+    };
+
+    // Index 0 searches forward from the source, 1 backward from the target.
+    // prev of the backward search is the next vertex on the way to the target
+    std::vector<int32_t> distance[2] = { std::vector<int32_t>(this->numV, INT32_MAX), std::vector<int32_t>(this->numV, INT32_MAX) };
+    std::vector<int32_t> prev[2] = { std::vector<int32_t>(this->numV, -1), std::vector<int32_t>(this->numV, -1) };
+    Heap heaps[2] = { Heap(this->numV), Heap(this->numV) };
+    // Keys leave each heap in increasing order, so the last one bounds everything still in it
+    long long lastKey[2] = { 0, 0 };
+    long long best = INT32_MAX;
+    int meet = -1;
+
+    distance[0][source] = 0;
+    heaps[0].Insert(Element{ source, 0 });
+    distance[1][target] = 0;
+    heaps[1].Insert(Element{ target, 0 });
+    if (source == target) {
+        best = 0;
+        meet = source;
+    }
+
+    // Once either side runs dry, or the two frontiers together are as long as the best path
+    // seen, no unseen path can be shorter
+    while (heaps[0].Size() > 0 && heaps[1].Size() > 0 && lastKey[0] + lastKey[1] < best) {
+        // Grow the smaller frontier
+        int side = heaps[0].Size() <= heaps[1].Size() ? 0 : 1;
+        std::vector<int32_t>& dist = distance[side];
+        const std::vector<int32_t>& other = distance[1 - side];
+        int currIdx = heaps[side].DeleteMin();
+        result.settled++;
+        lastKey[side] = dist[currIdx];
+
+        auto relax = [&](int to, int weight) {
+            int newDist = dist[currIdx] + weight;
+            if (dist[to] == INT32_MAX) {
+                dist[to] = newDist;
+                prev[side][to] = currIdx;
+                heaps[side].Insert(Element{ to, newDist });
+            } else if (newDist < dist[to]) {
+                dist[to] = newDist;
+                prev[side][to] = currIdx;
+                heaps[side].DecreaseKey(to, newDist);
+            }
+            // The edge joins the two searches
+            if (other[to] != INT32_MAX && (long long)newDist + other[to] < best) {
+                best = (long long)newDist + other[to];
+                meet = to;
+            }
+        };
+        if (side == 0)
+            this->ForEachNeighbor(currIdx, relax);
+        else
+            forEachInEdge(currIdx, relax);
+    }
+
+    if (meet != -1) {
+        result.distance = best;
+        result.path = TracePath(prev[0], meet);
+        for (int v = prev[1][meet]; v != -1; v = prev[1][v]) {
+            result.path.push_back(v + 1);
+        }
+    }
+    return result;
+}
+
+template <typename Heap>
+PathResult Graph::AStar(int source, int target, const std::function<int(int)>& heuristic) const {
+    PathResult result{ INT32_MAX, {}, 0 };
+    if (!this->IsVertex(source) || !this->IsVertex(target))
+        return result;
+    // Correct for 1 indexing
+    source--;
+    target--;
+
+    std::vector<int32_t> distance(this->numV, INT32_MAX);
+    std::vector<int32_t> prev(this->numV, -1);
+    // Heuristic values, asked for once per vertex with the caller's 1-indexed numbering
+    std::vector<int32_t> estimate(this->numV, -1);
+    auto estimateOf = [&](int v) {
+        if (estimate[v] == -1)
+            estimate[v] = heuristic(v + 1);
+        return estimate[v];
+    };
+
+    Heap heap(this->numV);
+    // Whether each vertex is in the heap right now
+    std::vector<char> queued(this->numV, false);
+    distance[source] = 0;
+    heap.Insert(Element{ source, estimateOf(source) });
+    queued[source] = true;
+
+    while (heap.Size() > 0) {
+        int currIdx = heap.DeleteMin();
+        queued[currIdx] = false;
+        result.settled++;
+        if (currIdx == target)
+            break;
+
+        int dist = distance[currIdx];
+        this->ForEachNeighbor(currIdx, [&](int to, int weight) {
+            int newDist = dist + weight;
+            if (newDist >= distance[to])
+                return;
+            distance[to] = newDist;
+            prev[to] = currIdx;
+            // Vertices already taken off come back only when the heuristic is inconsistent
+            if (queued[to]) {
+                heap.DecreaseKey(to, newDist + estimateOf(to));
+            } else {
+                heap.Insert(Element{ to, newDist + estimateOf(to) });
+                queued[to] = true;
+            }
+        });
+    }
+
+    if (distance[target] != INT32_MAX) {
+        result.distance = distance[target];
+        result.path = TracePath(prev, target);
+    }
+    return result;
+}
+
+void Graph::LoadCoordinates(std::string fileName) {
+    std::ifstream f;
+    f.open(fileName);
+    if (!f.good()) {
+        std::cerr << "Error reading file: " << fileName << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    this->coordinates.assign(this->numV, Point{ 0, 0 });
+    std::string line;
+    int lineNumber = 0;
+    while (getline(f, line)) {
+        lineNumber++;
+        // Skip comments and blank lines
+        if (line.empty() || line.at(0) == '#')
+            continue;
+
+        int v;
+        double x, y;
+        std::istringstream ss(line);
+        if (!(ss >> v >> x >> y) || v < 1 || v > this->numV) {
+            std::cerr << "Bad coordinates on line " << lineNumber << " of " << fileName << ": " << line << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        this->coordinates[v - 1] = Point{ x, y };
+    }
+}
+
+std::function<int(int)> Graph::EuclideanHeuristic(int target) const {
+    if (this->coordinates.empty())
+        return [](int) { return 0; };
+    Point t = this->coordinates[target - 1];
+    return [this, t](int v) {
+        Point p = this->coordinates[v - 1];
+        // Rounded down so an edge exactly as long as the straight line still counts as admissible
+        return (int)std::floor(std::hypot(p.x - t.x, p.y - t.y));
+    };
+}
+
+// The heap implementations point to point queries are built with
+template PathResult Graph::ShortestPath<MinHeap>(int source, int target) const;
+template PathResult Graph::ShortestPath<DaryHeap<4>>(int source, int target) const;
+template PathResult Graph::ShortestPath<DaryHeap<8>>(int source, int target) const;
+template PathResult Graph::ShortestPath<PairingHeap>(int source, int target) const;
+template PathResult Graph::ShortestPath<RadixHeap>(int source, int target) const;
+template PathResult Graph::BidirectionalDijkstra<MinHeap>(int source, int target) const;
+template PathResult Graph::BidirectionalDijkstra<DaryHeap<4>>(int source, int target) const;
+template PathResult Graph::BidirectionalDijkstra<DaryHeap<8>>(int source, int target) const;
+template PathResult Graph::BidirectionalDijkstra<PairingHeap>(int source, int target) const;
+template PathResult Graph::BidirectionalDijkstra<RadixHeap>(int source, int target) const;
+template PathResult Graph::AStar<MinHeap>(int source, int target, const std::function<int(int)>& heuristic) const;
+template PathResult Graph::AStar<DaryHeap<4>>(int source, int target, const std::function<int(int)>& heuristic) const;
+template PathResult Graph::AStar<DaryHeap<8>>(int source, int target, const std::function<int(int)>& heuristic) const;
+template PathResult Graph::AStar<PairingHeap>(int source, int target, const std::function<int(int)>& heuristic) const;
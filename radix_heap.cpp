@@ -0,0 +1,107 @@
+#include <iostream>
+#include "radix_heap.h"
+#include "stats.h"
+
+RadixHeap::RadixHeap(int capacity)
+    : capacity(capacity), size(0), last(0), buckets(numBuckets),
+    keys(capacity), bucketOf(capacity, -1), position(capacity) {}
+
+RadixHeap::RadixHeap(std::vector<Element> arr)
+    : RadixHeap(arr.size()) {
+    for (auto el : arr) {
+        this->Insert(el);
+    }
+}
+
+int RadixHeap::Size() {
+    return this->size;
+}
+
+void RadixHeap::Insert(Element el) {
+    if (this->size == this->capacity) {
+        // Full
+        std::cout << "error: cannot insert; heap is full" << std::endl;
+        return;
+    }
+    this->keys[el.ID] = el.key;
+    this->Place(el.ID);
+    this->size++;
+}
+
+void RadixHeap::DecreaseKey(int ID, int newKey) {
+    // Don't do anything if ID was popped
+    if (ID >= this->capacity || this->bucketOf[ID] == -1)
+        return;
+    int oldBucket = this->bucketOf[ID];
+    this->Remove(ID);
+    this->keys[ID] = newKey;
+    this->Place(ID);
+    // Moving to a lower bucket is the radix heap's bubble up, one level per bucket
+    if constexpr (collectStats) {
+        int levels = oldBucket - this->bucketOf[ID];
+        Stats().decreaseKeys++;
+        Stats().decreaseKeysMoved += levels > 0;
+        if (levels > 0) {
+            Stats().bubbleUps++;
+            Stats().bubbleUpLevels += levels;
+        }
+    }
+}
+
+int RadixHeap::DeleteMin() {
+    if (this->size == 0) {
+        // Empty
+        std::cout << "error: cannot delete min; heap is empty" << std::endl;
+        return -1;
+    }
+    if (this->buckets[0].empty()) {
+        // Find the first non-empty bucket and move its minimum to last
+        int b = 1;
+        while (this->buckets[b].empty())
+            b++;
+        unsigned newLast = this->keys[this->buckets[b][0]];
+        for (int ID : this->buckets[b]) {
+            if (this->keys[ID] < newLast)
+                newLast = this->keys[ID];
+        }
+        this->last = newLast;
+        // Every element now differs from last in a lower bit, so they all move down
+        std::vector<int> moving;
+        moving.swap(this->buckets[b]);
+        for (int ID : moving) {
+            this->Place(ID);
+        }
+        // Counted as one sift down whose depth is the elements redistributed
+        if constexpr (collectStats) {
+            Stats().siftDowns++;
+            Stats().siftDownLevels += moving.size();
+        }
+    }
+    int ID = this->buckets[0].back();
+    this->buckets[0].pop_back();
+    this->bucketOf[ID] = -1;
+    this->size--;
+    return ID;
+}
+
+int RadixHeap::Bucket(unsigned key) {
+    unsigned diff = key ^ this->last;
+    return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+}
+
+void RadixHeap::Place(int ID) {
+    int b = this->Bucket(this->keys[ID]);
+    this->bucketOf[ID] = b;
+    this->position[ID] = this->buckets[b].size();
+    this->buckets[b].push_back(ID);
+}
+
+void RadixHeap::Remove(int ID) {
+    // Swap with the back of the bucket and pop
+    std::vector<int>& bucket = this->buckets[this->bucketOf[ID]];
+    int moved = bucket.back();
+    bucket[this->position[ID]] = moved;
+    this->position[moved] = this->position[ID];
+    bucket.pop_back();
+    this->bucketOf[ID] = -1;
+}
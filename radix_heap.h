@@ -0,0 +1,42 @@
+#if !defined(RADIX_HEAP_H)
+#define RADIX_HEAP_H
+
+#include <vector>
+#include "min_heap.h"
+
+// Indexed monotone radix heap for non-negative integer keys; same interface as MinHeap.
+// Keys may never go below the last deleted minimum, which holds for Dijkstra
+// with non-negative weights but not for Prim.
+class RadixHeap {
+private:
+    static const int numBuckets = 33;
+
+    int capacity; // Max size
+    int size; // Current size
+    unsigned last; // Last deleted minimum
+    // Bucket b > 0 holds keys whose highest bit differing from last is bit b - 1
+    std::vector<std::vector<int>> buckets;
+    // Per ID fields
+    std::vector<unsigned> keys;
+    std::vector<int> bucketOf; // -1 if not in the heap
+    std::vector<int> position; // Index inside its bucket
+
+    int Bucket(unsigned key);
+    void Place(int ID);
+    void Remove(int ID);
+
+public:
+    // Empty heap with specified capacity
+    RadixHeap(int capacity);
+    // Intialize heap from existing array
+    RadixHeap(std::vector<Element> arr);
+
+    int Size();
+
+    void Insert(Element el);
+    void DecreaseKey(int ID, int newKey);
+    // Return -1 if no elements
+    int DeleteMin();
+};
+
+#endif // RADIX_HEAP_H
@@ -0,0 +1,103 @@
+#include <iomanip>
+#include <mutex>
+#include "stats.h"
+
+// One collector per thread, registered so DumpStats can add up threads that are still running.
+// A thread's counts fold into retired when it exits
+struct ThreadStats;
+
+struct StatsRegistry {
+    std::mutex mutex; // Guards live and retired
+    std::vector<ThreadStats*> live;
+    OperationStats retired;
+};
+
+// Built on first use, so it outlives the thread_local collector of the main thread
+static StatsRegistry& Registry() {
+    static StatsRegistry registry;
+    return registry;
+}
+
+static void Add(OperationStats& into, const OperationStats& from) {
+    into.decreaseKeys += from.decreaseKeys;
+    into.decreaseKeysMoved += from.decreaseKeysMoved;
+    into.bubbleUps += from.bubbleUps;
+    into.bubbleUpLevels += from.bubbleUpLevels;
+    into.siftDowns += from.siftDowns;
+    into.siftDownLevels += from.siftDownLevels;
+    into.edgesRelaxed += from.edgesRelaxed;
+    into.edgesImproved += from.edgesImproved;
+    if (into.levelVertices.size() < from.levelVertices.size()) {
+        into.levelVertices.resize(from.levelVertices.size(), 0);
+        into.levelEdges.resize(from.levelEdges.size(), 0);
+    }
+    for (size_t level = 0; level < from.levelVertices.size(); level++) {
+        into.levelVertices[level] += from.levelVertices[level];
+        into.levelEdges[level] += from.levelEdges[level];
+    }
+}
+
+struct ThreadStats {
+    OperationStats stats;
+
+    ThreadStats() {
+        StatsRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.push_back(this);
+    }
+
+    ~ThreadStats() {
+        StatsRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        Add(registry.retired, this->stats);
+        for (size_t i = 0; i < registry.live.size(); i++) {
+            if (registry.live[i] == this) {
+                registry.live[i] = registry.live.back();
+                registry.live.pop_back();
+                break;
+            }
+        }
+    }
+};
+
+OperationStats& Stats() {
+    thread_local ThreadStats thread;
+    return thread.stats;
+}
+
+void ResetStats() {
+    StatsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired = OperationStats();
+    for (ThreadStats* thread : registry.live)
+        thread->stats = OperationStats();
+}
+
+// a / b, 0 when nothing was counted
+static double Ratio(long long a, long long b) {
+    return b == 0 ? 0 : (double)a / b;
+}
+
+void DumpStats(std::ostream& out) {
+    OperationStats s;
+    {
+        StatsRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        s = registry.retired;
+        for (ThreadStats* thread : registry.live)
+            Add(s, thread->stats);
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "DecreaseKey: " << s.decreaseKeys << " calls, " << s.decreaseKeysMoved << " moved ("
+        << 100 * Ratio(s.decreaseKeysMoved, s.decreaseKeys) << "%)\n";
+    out << "BubbleUp: " << s.bubbleUps << " calls, average depth " << Ratio(s.bubbleUpLevels, s.bubbleUps) << "\n";
+    out << "SiftDown: " << s.siftDowns << " calls, average depth " << Ratio(s.siftDownLevels, s.siftDowns) << "\n";
+    out << "Edges: " << s.edgesRelaxed << " relaxed, " << s.edgesImproved << " improved ("
+        << 100 * Ratio(s.edgesImproved, s.edgesRelaxed) << "%)\n";
+    if (!s.levelVertices.empty()) {
+        out << "BFS level, vertices, edges\n";
+        for (size_t level = 0; level < s.levelVertices.size(); level++)
+            out << level << ", " << s.levelVertices[level] << ", " << s.levelEdges[level] << "\n";
+    }
+    out << std::defaultfloat;
+}
@@ -0,0 +1,45 @@
+#if !defined(STATS_H)
+#define STATS_H
+
+#include <iostream>
+#include <vector>
+
+// Operation counts for tuning heap arity and algorithm choice. Build with -DGRAPH_STATS
+// (make stats) to collect them; otherwise every update sits behind if constexpr on a false
+// flag and compiles away. Each thread counts into its own copy, so concurrent searches
+// (BatchBFS, BatchDijkstra) don't race; ResetStats and DumpStats cover every thread and
+// expect no algorithm to be running
+#if defined(GRAPH_STATS)
+constexpr bool collectStats = true;
+#else
+constexpr bool collectStats = false;
+#endif
+
+struct OperationStats {
+    // Heaps
+    long long decreaseKeys = 0;
+    long long decreaseKeysMoved = 0; // DecreaseKey calls that moved the element up at least one level
+    // Levels climbed and descended in the binary and d-ary heaps. The pairing heap counts a cut
+    // to under the root as one level up, and each DeleteMin as a sift down as deep as its links.
+    // The radix heap counts buckets dropped by DecreaseKey as levels up, and each bucket
+    // redistribution as a sift down as deep as the elements it moved
+    long long bubbleUps = 0;
+    long long bubbleUpLevels = 0;
+    long long siftDowns = 0;
+    long long siftDownLevels = 0;
+
+    // Dijkstra/Prim
+    long long edgesRelaxed = 0; // Edges looked at from a vertex leaving the heap
+    long long edgesImproved = 0; // Of those, edges that lowered a key
+
+    // BFS, indexed by level
+    std::vector<long long> levelVertices;
+    std::vector<long long> levelEdges;
+};
+
+OperationStats& Stats();
+void ResetStats();
+// Summary of everything counted since the last reset
+void DumpStats(std::ostream& out);
+
+#endif // STATS_H
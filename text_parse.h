@@ -0,0 +1,68 @@
+#if !defined(TEXT_PARSE_H)
+#define TEXT_PARSE_H
+
+#include <cstring>
+#include <string>
+
+// Scanning helpers for graph text held in memory. Each one works on [p, end) and never reads past end
+
+// Moves p to the start of the next line
+inline const char* NextLine(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    return nl == NULL ? end : nl + 1;
+}
+
+// Moves p past spaces and tabs, staying on the current line
+inline const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    return p;
+}
+
+// Parses a (possibly negative) decimal integer at p and moves p past it
+inline int ParseInt(const char*& p, const char* end) {
+    p = SkipBlanks(p, end);
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    int value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    return negative ? -value : value;
+}
+
+// ParseInt that reports whether there were any digits, so blank or truncated lines can be rejected
+inline bool ParseInt(const char*& p, const char* end, int& value) {
+    p = SkipBlanks(p, end);
+    const char* digits = p < end && *p == '-' ? p + 1 : p;
+    if (digits >= end || *digits < '0' || *digits > '9')
+        return false;
+    value = ParseInt(p, end);
+    return true;
+}
+
+// Returns the whitespace delimited token at p and moves p past it
+inline std::string ParseToken(const char*& p, const char* end) {
+    p = SkipBlanks(p, end);
+    const char* start = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+        p++;
+    return std::string(start, p);
+}
+
+// Whether anything other than a comment is left on the current line
+inline bool HasValue(const char* p, const char* end) {
+    p = SkipBlanks(p, end);
+    return p < end && *p != '\n' && *p != '#';
+}
+
+// Comments and blank lines carry no data
+inline bool IsSkippedLine(const char* p, const char* end) {
+    return p == end || *p == '#' || *p == '\n' || *p == '\r';
+}
+
+#endif // TEXT_PARSE_H
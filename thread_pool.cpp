@@ -0,0 +1,65 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int numThreads)
+    : numTasks(0), nextTask(0), finished(0), batch(0), stopping(false) {
+    if (numThreads <= 0)
+        numThreads = DefaultThreads();
+    for (int i = 0; i < numThreads; i++) {
+        this->workers.push_back(std::thread(&ThreadPool::Work, this));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (auto& w : this->workers)
+        w.join();
+}
+
+int ThreadPool::Size() const {
+    return this->workers.size();
+}
+
+void ThreadPool::Run(int numTasks, std::function<void(int)> task) {
+    if (numTasks <= 0)
+        return;
+    std::lock_guard<std::mutex> batchLock(this->runMutex);
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->task = task;
+    this->numTasks = numTasks;
+    this->nextTask = 0;
+    this->finished = 0;
+    this->batch++;
+    this->wake.notify_all();
+    this->done.wait(lock, [this] { return this->finished == this->numTasks; });
+}
+
+void ThreadPool::Work() {
+    int seenBatch = 0;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true) {
+        this->wake.wait(lock, [&] { return this->stopping || this->batch != seenBatch; });
+        if (this->stopping)
+            return;
+        seenBatch = this->batch;
+
+        // Keep taking tasks until the batch is handed out
+        while (this->nextTask < this->numTasks) {
+            int i = this->nextTask++;
+            lock.unlock();
+            this->task(i);
+            lock.lock();
+            this->finished++;
+        }
+        if (this->finished == this->numTasks)
+            this->done.notify_all();
+    }
+}
+
+int DefaultThreads() {
+    int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
@@ -0,0 +1,45 @@
+#if !defined(THREAD_POOL_H)
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of worker threads that run batches of indexed tasks
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex runMutex; // Held for a whole batch, so callers on other threads queue up
+    std::mutex mutex;
+    std::condition_variable wake; // Signals a new batch or shutdown
+    std::condition_variable done; // Signals the batch has finished
+
+    std::function<void(int)> task; // Task of the current batch
+    int numTasks; // Number of tasks in the current batch
+    int nextTask; // Next task index to hand out
+    int finished; // Tasks completed in the current batch
+    int batch; // Incremented for every batch so workers notice new work
+    bool stopping;
+
+    void Work();
+
+public:
+    // 0 threads uses every hardware thread
+    ThreadPool(int numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int Size() const;
+    // Runs task(i) for every i in [0, numTasks) and waits for all of them.
+    // Safe to call from several threads; batches run one after another. A task must not Run on its own pool
+    void Run(int numTasks, std::function<void(int)> task);
+};
+
+// Number of threads to use when 0 is requested
+int DefaultThreads();
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,43 @@
+#include "union_find.h"
+
+UnionFind::UnionFind(int n)
+    : parent(n), rank(n, 0), numSets(n) {
+    for (int i = 0; i < n; i++) {
+        this->parent[i] = i;
+    }
+}
+
+int UnionFind::Find(int x) {
+    int root = x;
+    while (this->parent[root] != root)
+        root = this->parent[root];
+    // Point everything on the path straight at the root
+    while (this->parent[x] != root) {
+        int next = this->parent[x];
+        this->parent[x] = root;
+        x = next;
+    }
+    return root;
+}
+
+bool UnionFind::Union(int a, int b) {
+    a = this->Find(a);
+    b = this->Find(b);
+    if (a == b)
+        return false;
+    // Hang the shorter tree under the taller one
+    if (this->rank[a] < this->rank[b]) {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+    this->parent[b] = a;
+    if (this->rank[a] == this->rank[b])
+        this->rank[a]++;
+    this->numSets--;
+    return true;
+}
+
+int UnionFind::NumSets() const {
+    return this->numSets;
+}
@@ -0,0 +1,57 @@
+#if !defined(UNION_FIND_H)
+#define UNION_FIND_H
+
+#include <atomic>
+#include <vector>
+
+// Disjoint sets over 0..n-1 with path compression and union by rank
+class UnionFind {
+private:
+    std::vector<int> parent;
+    std::vector<unsigned char> rank; // Upper bound on tree height, never above log2(n)
+    int numSets;
+
+public:
+    UnionFind(int n);
+
+    // Returns the representative of x's set
+    int Find(int x);
+    // Merges the sets of a and b, false if they were already the same set
+    bool Union(int a, int b);
+    int NumSets() const;
+};
+
+// Lock-free union-find over parent pointers, for any number of threads at once. Roots only
+// ever get linked under a smaller index, so concurrent links can't form a cycle and every
+// set's root is its smallest vertex
+inline int AtomicFind(std::vector<std::atomic<int>>& parent, int x) {
+    while (true) {
+        int p = parent[x].load(std::memory_order_relaxed);
+        if (p == x)
+            return x;
+        int gp = parent[p].load(std::memory_order_relaxed);
+        // Path halving; losing the race just means someone else shortened it
+        if (gp != p)
+            parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+inline bool AtomicUnion(std::vector<std::atomic<int>>& parent, int a, int b) {
+    while (true) {
+        a = AtomicFind(parent, a);
+        b = AtomicFind(parent, b);
+        if (a == b)
+            return false;
+        if (a < b) {
+            int tmp = a;
+            a = b;
+            b = tmp;
+        }
+        int expected = a;
+        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+            return true;
+    }
+}
+
+#endif // UNION_FIND_H